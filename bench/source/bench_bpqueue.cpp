@@ -0,0 +1,345 @@
+#include <benchmark/benchmark.h>  // for State, BENCHMARK_TEMPLATE, DoNotOptimize
+
+#include <algorithm>                   // for min, max, shuffle
+#include <cstddef>                     // for size_t
+#include <cstdint>                     // for int16_t, int32_t, uint16_t, uint32_t
+#include <mywheel/aligned_dllist.hpp>  // for AlignedDllist
+#include <mywheel/bpqueue.hpp>         // for BPQueue, BitmapBucketIndex, LazyMax
+#include <mywheel/radix_heap.hpp>      // for RadixHeap
+#include <random>                      // for mt19937, uniform_real_distribution
+#include <utility>                     // for pair
+#include <vector>                      // for vector
+
+using Item = Dllink<std::pair<int, uint32_t>>;
+using Sequence = std::vector<Dllist<std::pair<int, uint32_t>>>;
+
+/**
+ * @brief Initial gains and a cyclic sequence of key updates
+ *
+ * The updates are followed by their inverses in reverse order, so that
+ * replaying them any number of times keeps all keys inside [-pmax, pmax].
+ */
+struct Workload {
+    std::vector<int> gains;
+    std::vector<std::pair<uint32_t, int>> updates;
+};
+
+/**
+ * @brief Make a workload
+ *
+ * @param[in] n number of items
+ * @param[in] pmax key bound
+ * @param[in] skewed if true, a few hot items get most of the (small) updates and the gains are
+ * crowded near the top; otherwise items and deltas are uniformly random
+ */
+static auto make_workload(size_t n, int pmax, bool skewed) -> Workload {
+    auto gen = std::mt19937{42};  // NOLINT(cert-msc32-c, cert-msc51-cpp)
+    auto uniform = std::uniform_real_distribution<double>{0.0, 1.0};
+    auto res = Workload{std::vector<int>(n), {}};
+    for (auto &gain : res.gains) {
+        const auto u = uniform(gen);
+        const auto r = skewed ? 1.0 - u * u * u : u;
+        gain = int(r * 2 * pmax) - pmax;
+    }
+    auto gains = res.gains;
+    const auto num_updates = 4 * n;
+    res.updates.reserve(2 * num_updates);
+    for (auto i = 0U; i != num_updates; ++i) {
+        const auto u = uniform(gen);
+        const auto v = uint32_t(double(n) * (skewed ? u * u * u : u));
+        const auto w = uniform(gen) - 0.5;
+        const auto scale = skewed ? 4.0 : double(pmax);
+        const auto target = std::max(-pmax, std::min(pmax, gains[v] + int(w * scale)));
+        res.updates.emplace_back(v, target - gains[v]);
+        gains[v] = target;
+    }
+    for (auto i = num_updates; i != 0; --i) {
+        res.updates.emplace_back(res.updates[i - 1].first, -res.updates[i - 1].second);
+    }
+    return res;
+}
+
+/**
+ * @brief Append all items, then pop them all
+ */
+template <typename BucketIndex> static void BM_BPQueue_AppendPopleft(benchmark::State &state) {
+    const auto pmax = int(state.range(0));
+    const auto n = size_t(state.range(1));
+    const auto workload = make_workload(n, pmax, false);
+    auto nodes = std::vector<Item>(n);
+    auto bpq = BPQueue<int, int32_t, Sequence, BucketIndex>{-pmax, pmax};
+    for (auto _ : state) {
+        for (auto v = 0U; v != n; ++v) {
+            bpq.append(nodes[v], workload.gains[v]);
+        }
+        while (!bpq.is_empty()) {
+            benchmark::DoNotOptimize(&bpq.popleft());
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(n));
+}
+BENCHMARK_TEMPLATE(BM_BPQueue_AppendPopleft, LinearBucketScan)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}});
+BENCHMARK_TEMPLATE(BM_BPQueue_AppendPopleft, BitmapBucketIndex)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}});
+
+/**
+ * @brief Same as BM_BPQueue_AppendPopleft, with RadixHeap
+ */
+static void BM_RadixHeap_AppendPopleft(benchmark::State &state) {
+    const auto pmax = int(state.range(0));
+    const auto n = size_t(state.range(1));
+    const auto workload = make_workload(n, pmax, false);
+    auto nodes = std::vector<Item>(n);
+    auto rh = RadixHeap<int, int32_t>{-pmax, pmax};
+    for (auto _ : state) {
+        rh.clear();
+        for (auto v = 0U; v != n; ++v) {
+            rh.append(nodes[v], workload.gains[v]);
+        }
+        while (!rh.is_empty()) {
+            benchmark::DoNotOptimize(&rh.popleft());
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(n));
+}
+BENCHMARK(BM_RadixHeap_AppendPopleft)->ArgsProduct({{16, 2000, 1 << 20}, {1 << 10, 1 << 16}});
+
+/**
+ * @brief Replay the key updates of a workload through modify_key
+ */
+template <typename BucketIndex> static void BM_BPQueue_ModifyKey(benchmark::State &state) {
+    const auto pmax = int(state.range(0));
+    const auto n = size_t(state.range(1));
+    const auto skewed = state.range(2) != 0;
+    const auto workload = make_workload(n, pmax, skewed);
+    auto nodes = std::vector<Item>(n);
+    auto bpq = BPQueue<int, int32_t, Sequence, BucketIndex>{-pmax, pmax};
+    for (auto v = 0U; v != n; ++v) {
+        bpq.append(nodes[v], workload.gains[v]);
+    }
+    for (auto _ : state) {
+        for (const auto &update : workload.updates) {
+            bpq.modify_key(nodes[update.first], update.second);
+        }
+        benchmark::DoNotOptimize(bpq.get_max());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(workload.updates.size()));
+    state.SetLabel(skewed ? "skewed" : "random");
+}
+BENCHMARK_TEMPLATE(BM_BPQueue_ModifyKey, LinearBucketScan)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_BPQueue_ModifyKey, BitmapBucketIndex)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_BPQueue_ModifyKey, LazyMax<LinearBucketScan>)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_BPQueue_ModifyKey, LazyMax<BitmapBucketIndex>)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}, {0, 1}});
+
+/**
+ * @brief Traverse the whole queue with BpqIterator
+ */
+template <typename BucketIndex> static void BM_BPQueue_Iterate(benchmark::State &state) {
+    const auto pmax = int(state.range(0));
+    const auto n = size_t(state.range(1));
+    const auto workload = make_workload(n, pmax, false);
+    auto nodes = std::vector<Item>(n);
+    auto bpq = BPQueue<int, int32_t, Sequence, BucketIndex>{-pmax, pmax};
+    for (auto v = 0U; v != n; ++v) {
+        bpq.append(nodes[v], workload.gains[v]);
+    }
+    for (auto _ : state) {
+        auto sum = 0U;
+        for (auto &it : bpq) {
+            sum += it.data.second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(n));
+}
+BENCHMARK_TEMPLATE(BM_BPQueue_Iterate, LinearBucketScan)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}});
+BENCHMARK_TEMPLATE(BM_BPQueue_Iterate, BitmapBucketIndex)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}});
+
+/**
+ * @brief Append the nodes in a random order, so that consecutive items of a bucket are far apart
+ */
+static auto append_shuffled(BPQueue<int> &bpq, std::vector<Item> &nodes, int pmax) -> void {
+    auto order = std::vector<uint32_t>(nodes.size());
+    for (auto v = 0U; v != order.size(); ++v) {
+        order[v] = v;
+    }
+    auto gen = std::mt19937{42};  // NOLINT(cert-msc32-c, cert-msc51-cpp)
+    std::shuffle(order.begin(), order.end(), gen);
+    for (const auto v : order) {
+        bpq.append(nodes[v], int(v % uint32_t(2 * pmax + 1)) - pmax);
+    }
+}
+
+/**
+ * @brief Traverse a queue far larger than the cache, without (0) or with prefetching (Distance)
+ */
+template <size_t Distance> static void BM_BPQueue_IterateLarge(benchmark::State &state) {
+    const auto pmax = int(state.range(0));
+    const auto n = size_t(state.range(1));
+    auto nodes = std::vector<Item>(n);
+    auto bpq = BPQueue<int>{-pmax, pmax};
+    append_shuffled(bpq, nodes, pmax);
+    for (auto _ : state) {
+        auto sum = 0U;
+        if constexpr (Distance == 0) {
+            for (auto &it : bpq) {
+                sum += it.data.second;
+            }
+        } else {
+            for (auto &it : bpq.prefetch_range<Distance>()) {
+                sum += it.data.second;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(n));
+}
+BENCHMARK_TEMPLATE(BM_BPQueue_IterateLarge, 0)->ArgsProduct({{16}, {1 << 16, 1 << 22}});
+BENCHMARK_TEMPLATE(BM_BPQueue_IterateLarge, 4)->ArgsProduct({{16}, {1 << 16, 1 << 22}});
+BENCHMARK_TEMPLATE(BM_BPQueue_IterateLarge, 16)->ArgsProduct({{16}, {1 << 16, 1 << 22}});
+
+/**
+ * @brief Pop all the items of a queue far larger than the cache, with popleft() or
+ * popleft_prefetch()
+ */
+template <bool Prefetch> static void BM_BPQueue_PopleftLarge(benchmark::State &state) {
+    const auto pmax = int(state.range(0));
+    const auto n = size_t(state.range(1));
+    auto nodes = std::vector<Item>(n);
+    auto bpq = BPQueue<int>{-pmax, pmax};
+    for (auto _ : state) {
+        state.PauseTiming();
+        append_shuffled(bpq, nodes, pmax);
+        state.ResumeTiming();
+        auto sum = 0;
+        while (!bpq.is_empty()) {
+            auto &it = Prefetch ? bpq.popleft_prefetch() : bpq.popleft();
+            sum += it.data.first;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(n));
+}
+BENCHMARK_TEMPLATE(BM_BPQueue_PopleftLarge, false)->ArgsProduct({{16}, {1 << 16, 1 << 22}});
+BENCHMARK_TEMPLATE(BM_BPQueue_PopleftLarge, true)->ArgsProduct({{16}, {1 << 16, 1 << 22}});
+
+/**
+ * @brief Fill the queue with build() (compare with BM_BPQueue_AppendPopleft)
+ */
+template <typename BucketIndex> static void BM_BPQueue_BuildPopleft(benchmark::State &state) {
+    const auto pmax = int(state.range(0));
+    const auto n = size_t(state.range(1));
+    const auto workload = make_workload(n, pmax, false);
+    auto nodes = std::vector<Item>(n);
+    auto bpq = BPQueue<int, int32_t, Sequence, BucketIndex>{-pmax, pmax};
+    for (auto _ : state) {
+        bpq.build(nodes, workload.gains);
+        while (!bpq.is_empty()) {
+            benchmark::DoNotOptimize(&bpq.popleft());
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(n));
+}
+BENCHMARK_TEMPLATE(BM_BPQueue_BuildPopleft, LinearBucketScan)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}});
+BENCHMARK_TEMPLATE(BM_BPQueue_BuildPopleft, BitmapBucketIndex)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}});
+
+/**
+ * @brief Fill the queue with the parallel build() on 1, 2 and 4 threads
+ */
+static void BM_BPQueue_BuildParallel(benchmark::State &state) {
+    const auto n = size_t(state.range(0));
+    const auto num_threads = size_t(state.range(1));
+    const auto workload = make_workload(n, 2000, false);
+    auto nodes = std::vector<Item>(n);
+    auto bpq = BPQueue<int, int32_t>{-2000, 2000};
+    for (auto _ : state) {
+        bpq.build(nodes, workload.gains, num_threads);
+        state.PauseTiming();
+        bpq.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(n));
+}
+BENCHMARK(BM_BPQueue_BuildParallel)->ArgsProduct({{1 << 16, 1 << 20}, {1, 2, 4}})->UseRealTime();
+
+/**
+ * @brief Replay the key updates through modify_key, packed vs aligned node layout
+ *
+ * With 16-bit payloads and keys, a packed Dllink takes 2 pointers + 4 bytes, so that most of
+ * its pointers are misaligned in an array, while an AlignedDllink is padded to 3 pointers.
+ */
+template <typename Seq> static void BM_BPQueue_Layout(benchmark::State &state) {
+    using Node = typename Seq::value_type::node_type;
+    const auto pmax = int(state.range(0));
+    const auto n = size_t(state.range(1));
+    const auto workload = make_workload(n, pmax, false);
+    auto nodes = std::vector<Node>(n);
+    auto bpq = BPQueue<uint16_t, int16_t, Seq>{int16_t(-pmax), int16_t(pmax)};
+    for (auto v = 0U; v != n; ++v) {
+        bpq.append(nodes[v], int16_t(workload.gains[v]));
+    }
+    for (auto _ : state) {
+        for (const auto &update : workload.updates) {
+            bpq.modify_key(nodes[update.first], int16_t(update.second));
+        }
+        benchmark::DoNotOptimize(bpq.get_max());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(workload.updates.size()));
+    state.SetLabel(sizeof(Node) == 2 * sizeof(void *) + 4 ? "packed" : "aligned");
+}
+BENCHMARK_TEMPLATE(BM_BPQueue_Layout, std::vector<Dllist<std::pair<uint16_t, uint16_t>>>)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}});
+BENCHMARK_TEMPLATE(BM_BPQueue_Layout, std::vector<AlignedDllist<std::pair<uint16_t, uint16_t>>>)
+    ->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}});
+
+/**
+ * @brief Apply the updates of a pass, then undo them by the inverse updates (FM rollback)
+ */
+static void BM_BPQueue_UndoReplay(benchmark::State &state) {
+    const auto pmax = int(state.range(0));
+    const auto n = size_t(state.range(1));
+    const auto workload = make_workload(n, pmax, false);
+    auto nodes = std::vector<Item>(n);
+    auto bpq = BPQueue<int, int32_t>{-pmax, pmax};
+    bpq.build(nodes, workload.gains);
+    for (auto _ : state) {
+        for (const auto &[v, delta] : workload.updates) {  // forward, then inverse
+            bpq.modify_key(nodes[v], delta);
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(workload.updates.size() / 2));
+}
+BENCHMARK(BM_BPQueue_UndoReplay)->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}});
+
+/**
+ * @brief Same as BM_BPQueue_UndoReplay, undoing by BpqJournal's rollback_to()
+ */
+static void BM_BPQueue_UndoRollback(benchmark::State &state) {
+    const auto pmax = int(state.range(0));
+    const auto n = size_t(state.range(1));
+    const auto workload = make_workload(n, pmax, false);
+    const auto num_forward = workload.updates.size() / 2;
+    auto nodes = std::vector<Item>(n);
+    auto bpq = BPQueue<int, int32_t, Sequence, LinearBucketScan, NoBpqStats, BpqJournal>{-pmax,
+                                                                                         pmax};
+    bpq.undo_log().set_capacity(num_forward);
+    bpq.build(nodes, workload.gains);
+    for (auto _ : state) {
+        const auto cp = bpq.checkpoint();
+        for (auto i = 0U; i != num_forward; ++i) {
+            bpq.modify_key(nodes[workload.updates[i].first], workload.updates[i].second);
+        }
+        benchmark::DoNotOptimize(bpq.rollback_to(cp));
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(num_forward));
+}
+BENCHMARK(BM_BPQueue_UndoRollback)->ArgsProduct({{16, 2000}, {1 << 10, 1 << 16}});
@@ -0,0 +1,155 @@
+#include <benchmark/benchmark.h>  // for State, BENCHMARK, DoNotOptimize
+
+#include <cstdint>                        // for uint32_t
+#include <mutex>                          // for mutex, lock_guard
+#include <mywheel/concurrent_dllist.hpp>  // for ConcurrentDllist, ConcurrentDllink
+#include <mywheel/dllist.hpp>             // for Dllist, Dllink
+#include <utility>                        // for pair
+#include <vector>                         // for vector
+
+/**
+ * @brief Append all nodes to a list, then pop them all from the front
+ */
+static void BM_Dllist_AppendPopleft(benchmark::State &state) {
+    const auto n = size_t(state.range(0));
+    auto nodes = std::vector<Dllink<std::pair<int, uint32_t>>>(n);
+    auto list = Dllist<std::pair<int, uint32_t>>{};
+    list.clear();
+    for (auto _ : state) {
+        for (auto &node : nodes) {
+            list.append(node);
+        }
+        while (!list.is_empty()) {
+            benchmark::DoNotOptimize(&list.popleft());
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(n));
+}
+BENCHMARK(BM_Dllist_AppendPopleft)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+/**
+ * @brief Traverse a list from the front
+ */
+static void BM_Dllist_Iterate(benchmark::State &state) {
+    const auto n = size_t(state.range(0));
+    auto nodes = std::vector<Dllink<std::pair<int, uint32_t>>>(n);
+    auto list = Dllist<std::pair<int, uint32_t>>{};
+    list.clear();
+    for (auto &node : nodes) {
+        list.append(node);
+    }
+    for (auto _ : state) {
+        auto sum = 0U;
+        for (auto &node : list) {
+            sum += node.data.second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(n));
+}
+BENCHMARK(BM_Dllist_Iterate)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+namespace {
+    constexpr auto kSharedNodes = size_t(1) << 12;  // nodes of the shared lists
+
+    /**
+     * @brief Dllist guarded by one mutex, as a baseline for ConcurrentDllist
+     */
+    struct MutexDllist {
+        std::mutex mutex;
+        Dllist<uint32_t> list;
+        std::vector<Dllink<uint32_t>> nodes;
+
+        MutexDllist() : nodes(kSharedNodes) {
+            this->list.clear();
+            for (auto &node : this->nodes) {
+                this->list.append(node);
+            }
+        }
+    };
+
+    struct SharedConcurrentDllist {
+        ConcurrentDllist<uint32_t> list;
+        std::vector<ConcurrentDllink<uint32_t>> nodes;
+
+        SharedConcurrentDllist() : nodes(kSharedNodes) {
+            for (auto &node : this->nodes) {
+                this->list.append(node);
+            }
+        }
+    };
+
+    MutexDllist mutex_dllist;
+    SharedConcurrentDllist concurrent_dllist;
+}  // namespace
+
+/**
+ * @brief Take a node from the front of a shared free list and give it back, by several threads
+ */
+static void BM_MutexDllist_PopleftAppend(benchmark::State &state) {
+    auto &shared = mutex_dllist;
+    for (auto _ : state) {
+        const auto lock = std::lock_guard<std::mutex>{shared.mutex};
+        auto &node = shared.list.popleft();
+        shared.list.append(node);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(BM_MutexDllist_PopleftAppend)->ThreadRange(1, 8)->UseRealTime();
+
+/**
+ * @brief Same as BM_MutexDllist_PopleftAppend, with ConcurrentDllist
+ */
+static void BM_ConcurrentDllist_PopleftAppend(benchmark::State &state) {
+    auto &shared = concurrent_dllist;
+    for (auto _ : state) {
+        if (auto *node = shared.list.popleft()) {
+            shared.list.append(*node);
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(BM_ConcurrentDllist_PopleftAppend)->ThreadRange(1, 8)->UseRealTime();
+
+/**
+ * @brief Detach the own nodes of each thread from the middle of a shared list and append them
+ * back, by several threads
+ */
+static void BM_MutexDllist_DetachAppend(benchmark::State &state) {
+    auto &shared = mutex_dllist;
+    const auto per_thread = kSharedNodes / size_t(state.threads());
+    auto i = size_t(state.thread_index()) * per_thread;
+    for (auto _ : state) {
+        auto &node = shared.nodes[i];
+        {
+            const auto lock = std::lock_guard<std::mutex>{shared.mutex};
+            shared.list.detach(node);
+            shared.list.append(node);
+        }
+        i = i + 1 == (size_t(state.thread_index()) + 1) * per_thread
+                ? size_t(state.thread_index()) * per_thread
+                : i + 1;
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(BM_MutexDllist_DetachAppend)->ThreadRange(1, 8)->UseRealTime();
+
+/**
+ * @brief Same as BM_MutexDllist_DetachAppend, with ConcurrentDllist
+ */
+static void BM_ConcurrentDllist_DetachAppend(benchmark::State &state) {
+    auto &shared = concurrent_dllist;
+    const auto per_thread = kSharedNodes / size_t(state.threads());
+    auto i = size_t(state.thread_index()) * per_thread;
+    for (auto _ : state) {
+        auto &node = shared.nodes[i];
+        if (shared.list.detach(node)) {
+            shared.list.append(node);
+        }
+        i = i + 1 == (size_t(state.thread_index()) + 1) * per_thread
+                ? size_t(state.thread_index()) * per_thread
+                : i + 1;
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(BM_ConcurrentDllist_DetachAppend)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>  // for State, BENCHMARK, DoNotOptimize
+
+#include <cstdint>            // for uint32_t
+#include <mywheel/robin.hpp>  // for Robin, FlatRobin
+
+/**
+ * @brief Visit all other parts, for every part
+ */
+static void BM_Robin_Exclude(benchmark::State &state) {
+    const auto k = uint32_t(state.range(0));
+    const auto rr = fun::Robin<uint32_t>{k};
+    for (auto _ : state) {
+        auto sum = 0U;
+        for (auto from_part = 0U; from_part != k; ++from_part) {
+            for (const auto to_part : rr.exclude(from_part)) {
+                sum += to_part;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(k) * int64_t(k - 1));
+}
+BENCHMARK(BM_Robin_Exclude)->RangeMultiplier(2)->Range(2, 1024);
+
+/**
+ * @brief Same as BM_Robin_Exclude, with FlatRobin
+ */
+static void BM_FlatRobin_Exclude(benchmark::State &state) {
+    const auto k = uint32_t(state.range(0));
+    const auto rr = fun::FlatRobin<uint32_t>{k};
+    for (auto _ : state) {
+        auto sum = 0U;
+        for (auto from_part = 0U; from_part != k; ++from_part) {
+            for (const auto to_part : rr.exclude(from_part)) {
+                sum += to_part;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(k) * int64_t(k - 1));
+}
+BENCHMARK(BM_FlatRobin_Exclude)->RangeMultiplier(2)->Range(2, 1024);
+
+/**
+ * @brief Same as BM_Robin_Exclude, with FlatRobin::for_each_excluding
+ */
+static void BM_FlatRobin_ForEachExcluding(benchmark::State &state) {
+    const auto k = uint32_t(state.range(0));
+    const auto rr = fun::FlatRobin<uint32_t>{k};
+    for (auto _ : state) {
+        auto sum = 0U;
+        for (auto from_part = 0U; from_part != k; ++from_part) {
+            rr.for_each_excluding(from_part, [&sum](uint32_t to_part) { sum += to_part; });
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(k) * int64_t(k - 1));
+}
+BENCHMARK(BM_FlatRobin_ForEachExcluding)->RangeMultiplier(2)->Range(2, 1024);
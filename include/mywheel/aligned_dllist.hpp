@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>  // for max
+#include <cstddef>    // for size_t
+
+#include "dllist.hpp"  // for Dllink, Dllist, DllIterator
+
+/**
+ * @brief Size budget of AlignedDllink<T>
+ *
+ * Two pointers, then the data at its own alignment, rounded up to the
+ * alignment of the node (the larger of a pointer's and T's), i.e. no
+ * padding beyond what natural alignment requires.
+ *
+ * @tparam T
+ */
+template <typename T> constexpr size_t aligned_dllink_budget = [] {
+    constexpr auto align = std::max(alignof(T), alignof(void *));
+    constexpr auto offset = (2 * sizeof(void *) + alignof(T) - 1) / alignof(T) * alignof(T);
+    return (offset + sizeof(T) + align - 1) / align * align;
+}();
+
+/**
+ * @brief naturally aligned layout of Dllink
+ *
+ * Same as PackedDllinkLayout, but without `#pragma pack(push, 1)`: the links
+ * are always aligned, at the cost of the padding of the data up to the
+ * alignment of a pointer. Use it on targets where unaligned pointer access
+ * is slow or traps, e.g. as
+ * BPQueue<Tp, Int, std::vector<AlignedDllist<std::pair<Tp, UInt>>>>.
+ */
+struct AlignedDllinkLayout {
+    template <typename T> static constexpr size_t budget
+        = aligned_dllink_budget<T>; /**< size limit of Dllink<T> */
+
+    /**
+     * @brief storage of a node: the links and the data
+     *
+     * @tparam Node the node type
+     * @tparam T the data type
+     */
+    template <typename Node, typename T> struct Links {
+        Node *next; /**< pointer to the next node */
+        Node *prev; /**< pointer to the previous node */
+        T data;     /**< data */
+    };
+};
+
+template <typename T> using AlignedDllink = Dllink<T, AlignedDllinkLayout>;
+template <typename T> using AlignedDllist = Dllist<T, AlignedDllinkLayout>;
+template <typename T> using AlignedDllIterator = DllIterator<T, AlignedDllinkLayout>;
@@ -2,7 +2,15 @@
 
 // #include <any>
 #include <cstddef>
+#include <iterator>  // for random_access_iterator_tag
+#include <utility>   // for std::move()
 #include <vector>
+#if __has_include(<version>)
+#    include <version>  // for __cpp_lib_span
+#endif
+#if defined(__cpp_lib_span)
+#    include <span>
+#endif
 
 /* The `RepeatArray` class is a template class that represents an array that repeats its elements.
 It has a constructor that takes a value and a size as parameters and initializes all elements of the
@@ -40,40 +48,54 @@ template <typename T> class RepeatArray {
     size_t size() const { return this->_size; }
 
     /**
-     * The code defines an iterator class for a repeat array, allowing iteration over the elements
-     * of the array.
+     * Returns the sum of the elements in closed form, i.e. value * size, without iterating.
+     *
+     * @return The sum of the elements.
+     */
+    T sum() const { return static_cast<T>(this->_value * static_cast<T>(this->_size)); }
+
+    /**
+     * Returns the number of elements equal to the given value in closed form, without iterating.
+     *
+     * @param[in] value The value to count.
+     * @return size() if the value is the repeated one, 0 otherwise.
+     */
+    size_t count(const T& value) const { return value == this->_value ? this->_size : 0; }
+
+    /**
+     * The code defines a random-access iterator class for a repeat array, allowing iteration over
+     * the elements of the array, also by the std:: algorithms (including the parallel ones).
      *
      * @return The `begin()` function returns an iterator pointing to the beginning of the
      * RepeatArray, while the `end()` function returns an iterator pointing to the end of the
      * RepeatArray.
      */
     class Iterator {
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
       private:
-        const RepeatArray<T>& _array;
-        size_t _count;
+        const T* _value{nullptr};
+        size_t _count{0};
 
       public:
+        Iterator() = default;
+
         /**
          * Constructor for the Iterator class.
          *
-         * Initializes an Iterator instance with a reference to the RepeatArray it will
-         * iterate over, and a count representing the current position in the iteration.
+         * Initializes an Iterator instance with a pointer to the value of the RepeatArray it
+         * will iterate over, and a count representing the current position in the iteration.
          *
          * @param[in] array Reference to the RepeatArray to iterate over.
          * @param[in] count Current position in the iteration.
          */
-        Iterator(const RepeatArray<T>& array, size_t count) : _array(array), _count(count) {}
-
-        /**
-         * Compares two Iterator instances for inequality.
-         *
-         * This operator overload checks if the current count of this Iterator
-         * is not equal to the count of the other Iterator passed in.
-         *
-         * @param[in] other Iterator to compare to.
-         * @return True if the counts are not equal, false otherwise.
-         */
-        bool operator!=(const Iterator& other) const { return this->_count != other._count; }
+        Iterator(const RepeatArray<T>& array, size_t count)
+            : _value(&array._value), _count(count) {}
 
         /**
          * Returns the value stored in the underlying RepeatArray.
@@ -84,7 +106,11 @@ template <typename T> class RepeatArray {
          *
          * @return The value stored in the underlying RepeatArray.
          */
-        T operator*() const { return this->_array._value; }
+        const T& operator*() const { return *this->_value; }
+
+        const T* operator->() const { return this->_value; }
+
+        const T& operator[](difference_type /* n */) const { return *this->_value; }
 
         /**
          * Pre-increment operator overload for Iterator class.
@@ -97,8 +123,61 @@ template <typename T> class RepeatArray {
             this->_count++;
             return *this;
         }
+
+        Iterator operator++(int) {
+            auto res = *this;
+            ++*this;
+            return res;
+        }
+
+        Iterator& operator--() {
+            this->_count--;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            auto res = *this;
+            --*this;
+            return res;
+        }
+
+        Iterator& operator+=(difference_type n) {
+            this->_count = static_cast<size_t>(static_cast<difference_type>(this->_count) + n);
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type n) { return *this += -n; }
+
+        friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+        friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+        friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+
+        friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) {
+            return static_cast<difference_type>(lhs._count)
+                   - static_cast<difference_type>(rhs._count);
+        }
+
+        /**
+         * Compares two Iterator instances for (in)equality and order, by their counts.
+         *
+         * @param[in] lhs Iterator to compare.
+         * @param[in] rhs Iterator to compare to.
+         */
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._count == rhs._count;
+        }
+        friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return !(lhs == rhs); }
+        friend bool operator<(const Iterator& lhs, const Iterator& rhs) {
+            return lhs._count < rhs._count;
+        }
+        friend bool operator>(const Iterator& lhs, const Iterator& rhs) { return rhs < lhs; }
+        friend bool operator<=(const Iterator& lhs, const Iterator& rhs) { return !(rhs < lhs); }
+        friend bool operator>=(const Iterator& lhs, const Iterator& rhs) { return !(lhs < rhs); }
     };
 
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+
     /**
      * Returns an iterator pointing to the first element of the container.
      *
@@ -129,12 +208,16 @@ template <typename T> class RepeatArray {
  * class provides `operator[]` overloads to access elements using shifted
  * indices.
  *
+ * The storage can also be a view, e.g. `ShiftArray<T, ArrayView<const T>>`
+ * over a memory-mapped file (see mapped_array.hpp), to avoid the copy.
+ *
  * @tparam T
+ * @tparam Container storage of the elements
  */
-template <typename T> class ShiftArray {
+template <typename T, typename Container = std::vector<T>> class ShiftArray {
   private:
     size_t _start = 0;
-    std::vector<T> _lst;
+    Container _lst;
 
   public:
     /**
@@ -142,9 +225,9 @@ template <typename T> class ShiftArray {
      * the lst variable to the input vector.
      *
      * @param[in] lst The parameter "lst" is a vector of type T, which is the type of elements
-     * stored in the vector.
+     * stored in the vector (or a view of the storage).
      */
-    explicit ShiftArray(std::vector<T> lst) : _lst(lst) {}
+    explicit ShiftArray(Container lst) : _lst(std::move(lst)) {}
 
     void set_start(size_t start) { this->_start = start; }
 
@@ -162,77 +245,68 @@ template <typename T> class ShiftArray {
      * @return The T& operator[] function returns a reference to an element in the lst vector, which
      * is accessed using the key parameter.
      */
-    T& operator[](size_t key) { return this->_lst[key - this->_start]; }
+    typename Container::reference operator[](size_t key) { return this->_lst[key - this->_start]; }
+
+    /**
+     * The iterators of a ShiftArray are those of its storage, which are contiguous (e.g. pointers
+     * for ArrayView), so that the std:: algorithms, including the parallel ones, and the
+     * vectorizer see through them. The elements are visited in the order of their keys, from
+     * `start` on.
+     */
+    using iterator = typename Container::iterator;
+    using const_iterator = typename Container::const_iterator;
+    using Iterator = const_iterator;
 
     /**
-     * The code defines a class Iterator that allows iteration over elements in a ShiftArray.
+     * The function returns an iterator pointing to the beginning of a container.
      *
-     * @return The code is returning an iterator object.
+     * @return an iterator object.
      */
-    class Iterator {
-      private:
-        const ShiftArray<T>& _array;
-        size_t _count;
+    const_iterator begin() const { return this->_lst.begin(); }
 
-      public:
-        /**
-         * The Iterator constructor takes a ShiftArray object and a count as parameters.
-         *
-         * @param[in] array The "array" parameter is of type "ShiftArray<T>", which is a template
-         * class representing an array that can be shifted (rotated) to the left or right. It is
-         * passed by reference to the constructor of the "Iterator" class.
-         * @param[in] count The count parameter is of type size_t and represents the number of
-         * elements in the ShiftArray that the Iterator will iterate over.
-         */
-        Iterator(const ShiftArray<T>& array, size_t count) : _array(array), _count(count) {}
+    /**
+     * The end() function returns an iterator pointing to the end of a list.
+     *
+     * @return The end iterator of the container.
+     */
+    const_iterator end() const { return this->_lst.end(); }
 
-        /**
-         * The function checks if the count of two iterators are not equal.
-         *
-         * @param[in] other The "other" parameter is a reference to another Iterator object.
-         *
-         * @return a boolean value.
-         */
-        bool operator!=(const Iterator& other) const { return this->_count != other._count; }
+    iterator begin() { return this->_lst.begin(); }
 
-        /**
-         * The function returns the value at the current position in an array.
-         *
-         * @return The code is returning the element at the index `array.start + count` in the
-         * `array.lst` array.
-         */
-        T operator*() const { return this->_array._lst[this->_array._start + this->_count]; }
+    iterator end() { return this->_lst.end(); }
 
-        /**
-         * The above function overloads the pre-increment operator for an Iterator class,
-         * incrementing the count variable and returning a reference to the updated object.
-         *
-         * @return The iterator object itself is being returned.
-         */
-        Iterator& operator++() {
-            this->_count++;
-            return *this;
-        }
-    };
+    /**
+     * The function returns a pointer to the element of key `start`, the first one in the
+     * storage.
+     *
+     * @return A pointer to the contiguous storage.
+     */
+    auto data() const { return this->_lst.data(); }
 
+    auto data() { return this->_lst.data(); }
+
+#if defined(__cpp_lib_span)
     /**
-     * The function returns an iterator pointing to the beginning of a container.
+     * The function returns a std::span over the storage (C++20).
      *
-     * @return an iterator object.
+     * @return A std::span of the elements, the first one with the key `start`.
      */
-    Iterator begin() const { return Iterator(*this, 0); }
+    auto span() const { return std::span{this->_lst.data(), this->_lst.size()}; }
+
+    auto span() { return std::span{this->_lst.data(), this->_lst.size()}; }
+#endif
 
     /**
-     * The end() function returns an iterator pointing to the end of a list.
+     * The function returns the first key, set by `set_start`.
      *
-     * @return The end iterator of the container.
+     * @return the value of start.
      */
-    Iterator end() const { return Iterator(*this, this->_lst.size() - this->_start); }
+    size_t start() const { return this->_start; }
 
     /**
-     * The function returns the size of a list, excluding a specified starting index.
+     * The function returns the size of the list.
      *
-     * @return the size of the list (lst) minus the starting index (start).
+     * @return the size of the list (lst), i.e. the keys are [start, start + size).
      */
-    size_t size() const { return this->_lst.size() - this->_start; }
+    size_t size() const { return this->_lst.size(); }
 };
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cassert>  // for assert
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t, uint64_t
+#include <vector>   // for vector
+
+/**
+ * @brief Kind of a BPQueue operation recorded in an undo log
+ */
+enum class BpqUndoOp : uint8_t {
+    attach,  //!< the item was attached; undone by detaching it
+    remove,  //!< the item was popped or detached; undone by reinserting it
+    relink,  //!< the item was moved to another bucket; undone by moving it back
+    shift,   //!< all keys were shifted by `key` (see BPQueue::shift_keys()); undone by -key
+};
+
+/**
+ * @brief Entry of a BpqUndoLog
+ *
+ * @tparam Item
+ * @tparam UInt
+ */
+template <typename Item, typename UInt> struct BpqUndoEntry {
+    Item *item;    //!< the item (nullptr for shift)
+    Item *prev;    //!< the node before the item in its old bucket (or the head of the bucket)
+    UInt key;      //!< the old internal key (the delta for shift)
+    BpqUndoOp op;  //!< kind of the operation
+};
+
+/**
+ * @brief Undo log of BPQueue operations, in a ring buffer
+ *
+ * Records, for every operation of the queue, the item, its old key and
+ * its old position (the node before it), so that BPQueue::rollback_to()
+ * can restore the links directly, in the reverse order, instead of
+ * replaying inverse modify_key() calls with their relinks and max
+ * searches. The ring keeps the latest capacity() entries: a checkpoint
+ * older than that can no longer be rolled back to.
+ *
+ * @tparam Item
+ * @tparam UInt
+ */
+template <typename Item, typename UInt> class BpqUndoLog {
+  public:
+    using entry_type = BpqUndoEntry<Item, UInt>;
+
+  private:
+    std::vector<entry_type> ring;
+    size_t mask{};
+    uint64_t head{};  //!< sequence number of the next entry
+    uint64_t tail{};  //!< sequence number of the oldest entry kept
+
+  public:
+    static constexpr bool enabled = true;
+
+    /**
+     * @brief Construct a new BpqUndoLog object
+     *
+     * @param[in] capacity number of entries kept (rounded up to a power of two)
+     */
+    explicit BpqUndoLog(size_t capacity = 4096) { this->set_capacity(capacity); }
+
+    /**
+     * @brief Change the number of entries kept, and forget all the entries
+     *
+     * @param[in] capacity number of entries kept (rounded up to a power of two)
+     */
+    auto set_capacity(size_t capacity) -> void {
+        auto n = size_t(1);
+        while (n < capacity) {
+            n *= 2;
+        }
+        this->ring.assign(n, entry_type{});
+        this->mask = n - 1;
+        this->clear();
+    }
+
+    auto capacity() const noexcept -> size_t { return this->ring.size(); }
+
+    /**
+     * @brief Number of entries kept
+     *
+     * @return size_t
+     */
+    auto size() const noexcept -> size_t { return size_t(this->head - this->tail); }
+
+    /**
+     * @brief Forget all the entries (the checkpoints taken so far become invalid)
+     */
+    auto clear() noexcept -> void { this->tail = ++this->head; }
+
+    auto push(const entry_type &entry) noexcept -> void {
+        this->ring[size_t(this->head) & this->mask] = entry;
+        ++this->head;
+        if (this->head - this->tail > this->ring.size()) {
+            ++this->tail;  // overwrite the oldest entry
+        }
+    }
+
+    auto pop() noexcept -> const entry_type & {
+        assert(this->head != this->tail);
+        --this->head;
+        return this->ring[size_t(this->head) & this->mask];
+    }
+
+    /**
+     * @brief The current position in the log
+     *
+     * @return uint64_t
+     */
+    auto checkpoint() const noexcept -> uint64_t { return this->head; }
+
+    /**
+     * @brief Whether all the entries since the checkpoint are still kept
+     *
+     * @param[in] cp the checkpoint
+     * @return true
+     * @return false
+     */
+    auto can_rollback_to(uint64_t cp) const noexcept -> bool {
+        return this->tail <= cp && cp <= this->head;
+    }
+};
+
+/**
+ * @brief No undo log (default journal policy of BPQueue)
+ */
+struct NoBpqJournal {
+    template <typename Item, typename UInt> struct log_type {
+        static constexpr bool enabled = false;
+    };
+};
+
+/**
+ * @brief Undo log journal policy of BPQueue (see BpqUndoLog)
+ */
+struct BpqJournal {
+    template <typename Item, typename UInt> using log_type = BpqUndoLog<Item, UInt>;
+};
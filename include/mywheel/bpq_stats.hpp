@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <vector>   // for vector
+
+/**
+ * @brief No statistics (default stats policy of BPQueue)
+ *
+ * All the hooks are empty, so that they compile to nothing.
+ */
+struct NoBpqStats {
+    /**
+     * @brief Construct a new NoBpqStats object
+     */
+    constexpr explicit NoBpqStats(size_t /* num_buckets */ = 0) noexcept {}
+
+    constexpr auto reset(size_t /* num_buckets */) noexcept -> void {}
+    constexpr auto on_attach(size_t /* key */) noexcept -> void {}
+    constexpr auto on_relink(size_t /* key */) noexcept -> void {}
+    constexpr auto on_popleft() noexcept -> void {}
+    constexpr auto on_modify_key() noexcept -> void {}
+    constexpr auto on_detach() noexcept -> void {}
+    constexpr auto on_scan(size_t /* num_buckets */) noexcept -> void {}
+    constexpr auto on_clear() noexcept -> void {}
+};
+
+/**
+ * @brief Counters of BPQueue operations (stats policy)
+ *
+ * Counts the calls of popleft(), modify_key() (one per item for
+ * modify_keys()) and detach(), the relinks of items to another bucket, and
+ * the buckets walked over while searching the next max, which tells how
+ * much time is spent on empty buckets. Also tracks the number of items in
+ * the queue, its peak, and the histogram of the internal keys (key - a + 1)
+ * the items were attached or relinked to. Read it through BPQueue::stats().
+ */
+struct BpqStats {
+    uint64_t num_popleft{};           //!< calls of popleft()
+    uint64_t num_modify_key{};        //!< calls of modify_key(), per item
+    uint64_t num_detach{};            //!< calls of detach()
+    uint64_t num_relink{};            //!< items moved to another bucket
+    uint64_t num_scanned{};           //!< buckets walked over in the max searches
+    size_t size{};                    //!< current number of items
+    size_t peak_size{};               //!< peak number of items
+    std::vector<uint64_t> histogram;  //!< attaches and relinks per internal key
+
+    /**
+     * @brief Construct a new BpqStats object
+     *
+     * @param[in] num_buckets number of buckets
+     */
+    explicit BpqStats(size_t num_buckets = 0) : histogram(num_buckets) {}
+
+    /**
+     * @brief Reset all the counters, for a new number of buckets
+     */
+    auto reset(size_t num_buckets) -> void { *this = BpqStats{num_buckets}; }
+
+    auto on_attach(size_t key) noexcept -> void {
+        this->histogram[key] += 1;
+        this->size += 1;
+        if (this->peak_size < this->size) {
+            this->peak_size = this->size;
+        }
+    }
+
+    auto on_relink(size_t key) noexcept -> void {
+        this->histogram[key] += 1;
+        this->num_relink += 1;
+    }
+
+    auto on_popleft() noexcept -> void {
+        this->num_popleft += 1;
+        this->size -= 1;
+    }
+
+    auto on_modify_key() noexcept -> void { this->num_modify_key += 1; }
+
+    auto on_detach() noexcept -> void {
+        this->num_detach += 1;
+        this->size -= 1;
+    }
+
+    auto on_scan(size_t num_buckets) noexcept -> void { this->num_scanned += num_buckets; }
+
+    auto on_clear() noexcept -> void { this->size = 0; }
+};
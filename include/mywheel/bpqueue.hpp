@@ -1,15 +1,46 @@
 #pragma once
 
+#include <algorithm>    // for max, min
 #include <cassert>      // for assert
-#include <cstdint>      // for int32_t
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t, uint8_t, uint16_t, UINT16_MAX
+#include <functional>   // for ref
+#include <iterator>     // for begin, end, size
+#include <limits>       // for numeric_limits
+#include <thread>       // for thread
 #include <type_traits>  // for make_unsigned_t, is_integral, integral_consta...
-#include <utility>      // for pair
+#include <utility>      // for pair, move
 #include <vector>       // for vector, vector<>::value_type, vector<>::const...
 
-#include "dllist.hpp"  // for Dllink, DllIterator
+#include "bpq_journal.hpp"   // for NoBpqJournal
+#include "bpq_stats.hpp"     // for NoBpqStats
+#include "bucket_index.hpp"  // for LinearBucketScan
+#include "dllist.hpp"        // for Dllink, DllIterator
+#include "prefetch.hpp"      // for prefetch_read, prefetch_write
 
 // Forward declaration for begin() end()
-template <typename Tp, typename Int> class BpqIterator;
+template <typename Tp, typename Int = int32_t,
+          typename Sequence = std::vector<Dllist<std::pair<Tp, std::make_unsigned_t<Int>>>>,
+          typename BucketIndex = LinearBucketScan, typename Stats = NoBpqStats,
+          typename Journal = NoBpqJournal, size_t Prefetch = 0>
+class BpqIterator;
+template <typename Tp, typename Int, typename Sequence, typename BucketIndex, typename Stats,
+          typename Journal, size_t Prefetch = 0>
+class BpqRange;
+
+/**
+ * @brief The narrowest unsigned type able to hold the internal keys of a BPQueue
+ *
+ * For the bounds [a..b], High = b - a + 1, e.g. a
+ * `BPQueue<int, int32_t, std::vector<Dllist<std::pair<int, bpq_key_t<2 * pmax + 1>>>>>`
+ * stores 8-bit keys for pmax < 128.
+ *
+ * @tparam High the highest internal key
+ */
+template <uint64_t High> using bpq_key_t = std::conditional_t<
+    High <= UINT8_MAX, uint8_t,
+    std::conditional_t<High <= UINT16_MAX, uint16_t,
+                       std::conditional_t<High <= UINT32_MAX, uint32_t, uint64_t>>>;
 
 /**
  * @brief Bounded priority queue
@@ -30,18 +61,52 @@ template <typename Tp, typename Int> class BpqIterator;
  *
  * All the member functions assume that the keys are inside the bounds.
  *
+ * The way the next non-empty bucket is located is selected by the
+ * BucketIndex policy: LinearBucketScan (default) walks down the bucket
+ * array, while BitmapBucketIndex keeps an occupancy bitmap next to the
+ * bucket array, which pays off for wide key ranges. Wrapping either of
+ * them in LazyMax defers the downward searches until the max is needed.
+ *
+ * The list type is taken from the Sequence, so that e.g. a
+ * std::vector<AlignedDllist<...>> (see aligned_dllist.hpp) selects the
+ * naturally aligned node layout instead of the packed Dllink.
+ * Likewise, the type of the key stored in each item is taken from the
+ * Sequence, so it may be narrower than Int (see bpq_key_t and key_fits()).
+ * A 16-bit key with IndexedDllSequence makes 12-byte nodes.
+ *
+ * The Stats policy receives a call on every operation. NoBpqStats (default)
+ * ignores them at no cost, while BpqStats counts them (see stats()).
+ *
+ * The Journal policy selects an undo log. With BpqJournal, every operation
+ * is recorded, so that rollback_to() can undo the operations since a
+ * checkpoint() by restoring the links directly (e.g. to return to the best
+ * prefix of an FM pass). It requires buckets with predecessor() and
+ * insert_after(), as Dllist, AlignedDllist and IndexedDllist provide.
+ *
  * @tparam Tp
  * @tparam Int
  * @tparam _Sequence
  * @tparam std::make_unsigned_t<Int>>>>
+ * @tparam BucketIndex max-tracking policy
+ * @tparam Stats statistics policy
+ * @tparam Journal undo log policy
  */
 template <typename Tp, typename Int = int32_t,
-          typename Sequence = std::vector<Dllist<std::pair<Tp, std::make_unsigned_t<Int>>>>>
+          typename Sequence = std::vector<Dllist<std::pair<Tp, std::make_unsigned_t<Int>>>>,
+          typename BucketIndex = LinearBucketScan, typename Stats = NoBpqStats,
+          typename Journal = NoBpqJournal>
 class BPQueue {
     using UInt = std::make_unsigned_t<Int>;
 
-    friend BpqIterator<Tp, Int>;
-    using Item = Dllink<std::pair<Tp, UInt>>;
+    template <typename, typename, typename, typename, typename, typename, size_t>
+    friend class BpqIterator;
+    template <typename, typename, typename, typename, typename, typename, size_t>
+    friend class BpqRange;
+    using Item = typename Sequence::value_type::node_type;
+    using Key = std::decay_t<decltype(std::declval<Item &>().data.second)>;  //!< stored key
+
+    static_assert(std::is_unsigned<Key>::value && sizeof(Key) <= sizeof(UInt),
+                  "the stored key must be unsigned and not wider than Int");
 
     // static_assert(std::is_same<Item, typename _Sequence::value_type>::value,
     //               "value_type must be the same as the underlying container");
@@ -55,10 +120,101 @@ class BPQueue {
 
   private:
     Item sentinel{};  //!< sentinel */
-    Sequence bucket;  //!< bucket, array of lists
-    UInt max{};       //!< max value
-    Int offset;       //!< a - 1
-    UInt high;        //!< b - a + 1
+    Sequence bucket;         //!< bucket, array of lists
+    BucketIndex index;       //!< occupancy index of bucket
+    mutable Stats counters;  //!< statistics
+    mutable UInt max{};      //!< max value (an upper bound of it if lazy)
+    Int offset;              //!< a - 1
+    UInt high;               //!< b - a + 1
+    typename Journal::template log_type<Item, UInt> journal;  //!< undo log
+
+    static constexpr bool lazy = is_lazy_bucket_index<BucketIndex>::value;
+    static constexpr bool journaled = decltype(journal)::enabled;
+
+    /**
+     * @brief Record an operation on it in the undo log, before it is made
+     */
+    constexpr auto record(BpqUndoOp op, Item &it) noexcept -> void {
+        if constexpr (journaled) {
+            if (op == BpqUndoOp::attach) {
+                this->journal.push({&it, nullptr, UInt(0), op});
+            } else {
+                auto &prev = this->bucket[it.data.second].predecessor(it);
+                this->journal.push({&it, &prev, it.data.second, op});
+            }
+        }
+    }
+
+    /**
+     * @brief Move all buckets by delta (see shift_keys())
+     */
+    constexpr auto shift_buckets(Int delta) noexcept -> void {
+        auto move_bucket = [this, delta](UInt k) {
+            const auto t = UInt(k + UInt(delta));  // modular arithmetic
+            assert(t > 0);
+            assert(t <= this->high);
+            this->bucket[t].splice_back(this->bucket[k]);
+            this->index.unmark_if_empty(this->bucket, k);
+            this->index.mark(t);
+            for (auto &it : this->bucket[t]) {
+                this->counters.on_relink(t);
+                it.data.second = Key(t);
+            }
+        };
+        if (delta > 0) {
+            for (auto k = this->max; k != 0U; k = this->find_max(UInt(k - 1))) {
+                move_bucket(k);
+            }
+        } else {
+            for (auto k = UInt(1); k <= this->max; ++k) {
+                if (!this->bucket[k].is_empty()) {
+                    move_bucket(k);
+                }
+            }
+        }
+        this->max = UInt(this->max + UInt(delta));
+    }
+
+    /**
+     * @brief Find the highest non-empty bucket not above key
+     */
+    constexpr auto find_max(UInt key) const noexcept -> UInt {
+        const auto res = this->index.find_max(this->bucket, key);
+        this->counters.on_scan(size_t(key - res));
+        return res;
+    }
+
+    /**
+     * @brief Lower max down to the highest non-empty bucket (lazy mode only)
+     */
+    constexpr auto tighten() const noexcept -> void {
+        if constexpr (lazy) {
+            this->max = this->find_max(this->max);
+        }
+    }
+
+    /**
+     * @brief Link it into its bucket, after the items not after it by less (see append_sorted())
+     */
+    template <typename Less> constexpr auto insert_sorted(Item &it, Less less) noexcept -> void {
+        auto &&list = this->bucket[it.data.second];
+        auto &head = *list.end();
+        auto *at = &list.predecessor(head);
+        while (at != &head && less(it, *at)) {
+            at = &list.predecessor(*at);
+        }
+        list.insert_after(*at, it);
+        this->index.mark(it.data.second);
+    }
+
+    /**
+     * @brief Search the max downwards after a removal (eager mode only)
+     */
+    constexpr auto lower_max() noexcept -> void {
+        if constexpr (!lazy) {
+            this->max = this->find_max(this->max);
+        }
+    }
 
   public:
     /**
@@ -69,26 +225,69 @@ class BPQueue {
      */
     constexpr BPQueue(Int a, Int b)
         : bucket(static_cast<UInt>(b - a) + 2U),
+          index(static_cast<UInt>(b - a) + 2U),
+          counters(static_cast<UInt>(b - a) + 2U),
           offset(a - 1),
           high(static_cast<UInt>(b - offset)) {
         assert(a <= b);
+        assert(key_fits(a, b));
         static_assert(std::is_integral<Int>::value, "bucket's key must be an integer");
         bucket[0].appendleft(this->sentinel);  // sentinel
     }
 
+    /**
+     * @brief Construct a new BPQueue object over a prepared bucket array
+     *
+     * This allows the buckets to live elsewhere, e.g. in an IndexedDllPool.
+     * The bucket 0 of the given array must already hold a sentinel node.
+     *
+     * @param[in] a lower bound
+     * @param[in] b upper bound
+     * @param[in] bucket array of b - a + 2 lists
+     */
+    constexpr BPQueue(Int a, Int b, Sequence bucket)
+        : bucket(std::move(bucket)),
+          index(static_cast<UInt>(b - a) + 2U),
+          counters(static_cast<UInt>(b - a) + 2U),
+          offset(a - 1),
+          high(static_cast<UInt>(b - offset)) {
+        assert(a <= b);
+        assert(key_fits(a, b));
+        assert(this->bucket.size() == static_cast<UInt>(b - a) + 2U);
+        assert(!this->bucket[0].is_empty());
+        static_assert(std::is_integral<Int>::value, "bucket's key must be an integer");
+    }
+
     BPQueue(const BPQueue &) = delete;  // don't copy
     ~BPQueue() = default;
     constexpr auto operator=(const BPQueue &) -> BPQueue & = delete;  // don't assign
     constexpr BPQueue(BPQueue &&) noexcept = default;
     constexpr auto operator=(BPQueue &&) noexcept -> BPQueue & = default;  // don't assign
 
+    /**
+     * @brief Whether the stored key type can hold the keys of the bounds [a..b]
+     *
+     * Usable in a static_assert when the bounds are constant expressions.
+     *
+     * @param[in] a lower bound
+     * @param[in] b upper bound
+     * @return true
+     * @return false
+     */
+    static constexpr auto key_fits(Int a, Int b) noexcept -> bool {
+        return uint64_t(static_cast<UInt>(b - a)) + 1U <= uint64_t(std::numeric_limits<Key>::max());
+    }
+
     /**
      * @brief Whether the %BPQueue is empty.
      *
      * @return true
      * @return false
      */
-    constexpr auto is_empty() const noexcept -> bool { return this->max == 0U; }
+    constexpr auto is_empty() const noexcept -> bool {
+        this->tighten();
+        return this->max == 0U;
+    }
 
     /**
      * @brief Set the key object
@@ -97,7 +296,7 @@ class BPQueue {
      * @param[in] gain the key of it
      */
     constexpr auto set_key(Item &it, Int gain) noexcept -> void {
-        it.data.second = static_cast<UInt>(gain - this->offset);
+        it.data.second = static_cast<Key>(gain - this->offset);
     }
 
     /**
@@ -105,7 +304,17 @@ class BPQueue {
      *
      * @return Int maximum value
      */
-    constexpr auto get_max() const noexcept -> Int { return this->offset + Int(this->max); }
+    constexpr auto get_max() const noexcept -> Int {
+        this->tighten();
+        return this->offset + Int(this->max);
+    }
+
+    /**
+     * @brief Get the statistics (see BpqStats)
+     *
+     * @return const Stats&
+     */
+    constexpr auto stats() const noexcept -> const Stats & { return this->counters; }
 
     /**
      * @brief Clear reset the PQ
@@ -115,6 +324,86 @@ class BPQueue {
             this->bucket[this->max].clear();
             this->max -= 1;
         }
+        this->index.clear();
+        this->counters.on_clear();
+        if constexpr (journaled) {
+            this->journal.clear();
+        }
+    }
+
+    /**
+     * @brief Clear reset the PQ, visiting the occupied buckets only
+     *
+     * Unlike clear(), the empty buckets below max are skipped with the
+     * help of the occupancy index, hence this costs O(occupied buckets)
+     * with BitmapBucketIndex. The sentinel bucket is left untouched.
+     */
+    constexpr auto clear_all() noexcept -> void {
+        while (this->max > 0) {
+            this->bucket[this->max].clear();
+            this->index.unmark_if_empty(this->bucket, this->max);
+            this->max = this->find_max(UInt(this->max - 1));
+        }
+        this->counters.on_clear();
+        if constexpr (journaled) {
+            this->journal.clear();
+        }
+    }
+
+    /**
+     * @brief Clear the PQ and rebase it to the new bounds [a..b]
+     *
+     * The bucket storage is reused when its capacity allows, so that a
+     * queue can serve many passes without reallocation. Requires a
+     * resizable Sequence (e.g. std::vector), as created by BPQueue(a, b).
+     *
+     * @param[in] a lower bound
+     * @param[in] b upper bound
+     */
+    auto reset(Int a, Int b) -> void {
+        assert(a <= b);
+        assert(key_fits(a, b));
+        const auto num_buckets = static_cast<size_t>(static_cast<UInt>(b - a) + 2U);
+        const auto capacity = this->bucket.capacity();
+        this->clear_all();
+        this->bucket.resize(num_buckets);
+        if (num_buckets > capacity) {
+            // reallocated: the moved list heads still point to the old storage
+            for (auto &list : this->bucket) {
+                list.clear();
+            }
+        } else {
+            this->bucket[0].clear();
+        }
+        this->bucket[0].appendleft(this->sentinel);  // sentinel
+        this->index.reset(num_buckets);
+        this->counters.reset(num_buckets);
+        this->offset = a - 1;
+        this->high = static_cast<UInt>(b - this->offset);
+    }
+
+    /**
+     * @brief Add delta to the keys of all items
+     *
+     * Each non-empty bucket is moved as a whole to its new position by an
+     * O(1) splice, so that the order of the items within a bucket is kept
+     * and no item is relinked. Only the key stored in each item is
+     * rewritten. The buckets are visited from the destination side, so
+     * that a bucket is always spliced into an empty one.
+     *
+     * @param[in] delta the change of the keys
+     *
+     * Precondition: all the keys stay inside the bounds
+     */
+    constexpr auto shift_keys(Int delta) noexcept -> void {
+        this->tighten();
+        if (delta == 0 || this->max == 0U) {
+            return;
+        }
+        if constexpr (journaled) {
+            this->journal.push({nullptr, nullptr, UInt(delta), BpqUndoOp::shift});
+        }
+        this->shift_buckets(delta);
     }
 
     /**
@@ -135,11 +424,14 @@ class BPQueue {
      */
     constexpr auto appendleft(Item &it, Int k) noexcept -> void {
         assert(k > this->offset);
-        it.data.second = UInt(k - this->offset);
+        it.data.second = Key(k - this->offset);
         if (this->max < it.data.second) {
             this->max = it.data.second;
         }
+        this->record(BpqUndoOp::attach, it);
         this->bucket[it.data.second].appendleft(it);
+        this->index.mark(it.data.second);
+        this->counters.on_attach(it.data.second);
     }
 
     /**
@@ -150,11 +442,130 @@ class BPQueue {
      */
     constexpr auto append(Item &it, Int k) noexcept -> void {
         assert(k > this->offset);
-        it.data.second = UInt(k - this->offset);
+        it.data.second = Key(k - this->offset);
         if (this->max < it.data.second) {
             this->max = it.data.second;
         }
+        this->record(BpqUndoOp::attach, it);
         this->bucket[it.data.second].append(it);
+        this->index.mark(it.data.second);
+        this->counters.on_attach(it.data.second);
+    }
+
+    /**
+     * @brief Append item with external key, after the items of its bucket not after it by less
+     *
+     * A bucket whose items are all attached by append_sorted() (or
+     * modify_key_sorted()) stays sorted by less, so that its ties are
+     * popped in a defined order (e.g. by vertex id, see ShardedBPQueue).
+     * The position is searched from the back, so the cost is the number
+     * of items of the bucket that go after it, e.g. O(1) when the items
+     * come in order.
+     *
+     * @param[in,out] it the item
+     * @param[in] k  the key
+     * @param[in] less strict weak order of the items, as `less(const Item &, const Item &)`
+     */
+    template <typename Less>
+    constexpr auto append_sorted(Item &it, Int k, Less less) noexcept -> void {
+        assert(k > this->offset);
+        it.data.second = Key(k - this->offset);
+        if (this->max < it.data.second) {
+            this->max = it.data.second;
+        }
+        this->record(BpqUndoOp::attach, it);
+        this->insert_sorted(it, less);
+        this->counters.on_attach(it.data.second);
+    }
+
+    /**
+     * @brief Append a range of items with their external keys in bulk
+     *
+     * Equivalent to calling append(items[i], gains[i]) for each i, but
+     * without updating max per item: the max is searched once at the end,
+     * hence the total cost is O(n + range). Items with the same key keep
+     * their order in the range (as in a counting sort).
+     *
+     * @param[in,out] items range of items
+     * @param[in] gains range of the keys (same length)
+     */
+    template <typename ItemRange, typename GainRange>
+    constexpr auto build(ItemRange &items, const GainRange &gains) noexcept -> void {
+        auto gain = std::begin(gains);
+        for (auto &it : items) {
+            assert(Int(*gain) > this->offset);
+            it.data.second = Key(Int(*gain) - this->offset);
+            ++gain;
+            assert(it.data.second <= this->high);
+            this->record(BpqUndoOp::attach, it);
+            this->bucket[it.data.second].append(it);
+            this->index.mark(it.data.second);
+            this->counters.on_attach(it.data.second);
+        }
+        assert(gain == std::end(gains));
+        this->max = this->find_max(this->high);
+    }
+
+    /**
+     * @brief Append a range of items with their external keys in bulk, in parallel
+     *
+     * Same result as build(items, gains), including the order of the items
+     * with the same key. The range is cut into num_threads contiguous
+     * chunks; each worker links its chunk into buckets of its own, which
+     * are then spliced, chunk after chunk, to the back of this queue's
+     * buckets in O(range) per chunk. The Stats and Journal policies are
+     * not thread-safe, so a queue that enables either of them falls back
+     * to the sequential build().
+     *
+     * @param[in,out] items random access range of items
+     * @param[in] gains random access range of the keys (same length)
+     * @param[in] num_threads number of threads (0: hardware concurrency)
+     */
+    template <typename ItemRange, typename GainRange>
+    auto build(ItemRange &items, const GainRange &gains, size_t num_threads) -> void {
+        const auto n = size_t(std::size(items));
+        assert(n == size_t(std::size(gains)));
+        if (num_threads == 0) {
+            num_threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+        num_threads = std::min(num_threads, n);
+        if (journaled || !std::is_same<Stats, NoBpqStats>::value || num_threads <= 1) {
+            this->build(items, gains);
+            return;
+        }
+        auto fill = [&, n, num_threads](Sequence &lists, size_t t) {
+            const auto last = n * (t + 1) / num_threads;
+            for (auto v = n * t / num_threads; v != last; ++v) {
+                auto &it = items[v];
+                assert(Int(gains[v]) > this->offset);
+                it.data.second = Key(Int(gains[v]) - this->offset);
+                assert(it.data.second <= this->high);
+                lists[it.data.second].append(it);
+            }
+        };
+        auto locals = std::vector<Sequence>{};
+        locals.reserve(num_threads - 1);
+        auto workers = std::vector<std::thread>{};
+        workers.reserve(num_threads - 1);
+        for (auto t = size_t(1); t < num_threads; ++t) {
+            locals.emplace_back(size_t(this->high) + 1U);
+        }
+        for (auto t = size_t(1); t < num_threads; ++t) {
+            workers.emplace_back(fill, std::ref(locals[t - 1]), t);
+        }
+        fill(this->bucket, 0);
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        for (auto key = size_t(1); key <= size_t(this->high); ++key) {
+            for (auto &lists : locals) {
+                this->bucket[key].splice_back(lists[key]);
+            }
+            if (!this->bucket[key].is_empty()) {
+                this->index.mark(key);
+            }
+        }
+        this->max = this->find_max(this->high);
     }
 
     /**
@@ -163,9 +574,45 @@ class BPQueue {
      * @return Dllink&
      */
     constexpr auto popleft() noexcept -> Item & {
+        this->tighten();
+        if constexpr (journaled) {
+            this->record(BpqUndoOp::remove, *this->bucket[this->max].begin());
+        }
         auto &res = this->bucket[this->max].popleft();
-        while (this->bucket[this->max].is_empty()) {
-            this->max -= 1;
+        this->counters.on_popleft();
+        this->index.unmark_if_empty(this->bucket, this->max);
+        this->lower_max();
+        return res;
+    }
+
+    /**
+     * @brief The item that popleft() would pop
+     *
+     * Precondition: not empty
+     *
+     * @return Dllink&
+     */
+    constexpr auto front() noexcept -> Item & {
+        this->tighten();
+        assert(this->max != 0U);
+        return *this->bucket[this->max].begin();
+    }
+
+    /**
+     * @brief Pop node with the highest key, and prefetch the next one
+     *
+     * Same as popleft(), plus a prefetch of the node that the next
+     * popleft() will unlink (the new head of the highest bucket), so that
+     * its cache miss overlaps with the work of the caller on the popped
+     * node, on queues far larger than the cache.
+     *
+     * @return Dllink&
+     */
+    constexpr auto popleft_prefetch() noexcept -> Item & {
+        auto &res = this->popleft();
+        auto &top = this->bucket[this->max];
+        if (!top.is_empty()) {
+            prefetch_write(&*top.begin());
         }
         return res;
     }
@@ -180,19 +627,20 @@ class BPQueue {
      * For the Fiduccia-Mattheyses algorithm, this is a prefered behavior.
      */
     constexpr auto decrease_key(Item &it, UInt delta) noexcept -> void {
-        // this->bucket[it.data.second].detach(it)
-        it.detach();
-        it.data.second -= delta;
+        this->record(BpqUndoOp::relink, it);
+        this->bucket[it.data.second].detach(it);
+        this->index.unmark_if_empty(this->bucket, it.data.second);
+        it.data.second = Key(it.data.second - delta);
         assert(it.data.second > 0);
         assert(it.data.second <= this->high);
         this->bucket[it.data.second].append(it);  // FIFO
+        this->index.mark(it.data.second);
+        this->counters.on_relink(it.data.second);
         if (this->max < it.data.second) {
             this->max = it.data.second;
             return;
         }
-        while (this->bucket[this->max].is_empty()) {
-            this->max -= 1;
-        }
+        this->lower_max();
     }
 
     /**
@@ -205,12 +653,15 @@ class BPQueue {
      * For the Fiduccia-Mattheyses algorithm, this is a prefered behavior.
      */
     constexpr auto increase_key(Item &it, UInt delta) noexcept -> void {
-        // this->bucket[it.data.second].detach(it)
-        it.detach();
-        it.data.second += delta;
+        this->record(BpqUndoOp::relink, it);
+        this->bucket[it.data.second].detach(it);
+        this->index.unmark_if_empty(this->bucket, it.data.second);
+        it.data.second = Key(it.data.second + delta);
         assert(it.data.second > 0);
         assert(it.data.second <= this->high);
         this->bucket[it.data.second].appendleft(it);  // LIFO
+        this->index.mark(it.data.second);
+        this->counters.on_relink(it.data.second);
         if (this->max < it.data.second) {
             this->max = it.data.second;
         }
@@ -226,6 +677,7 @@ class BPQueue {
      * For Fiduccia-Mattheyses algorithm, this is a prefered behavior.
      */
     constexpr auto modify_key(Item &it, Int delta) noexcept -> void {
+        this->counters.on_modify_key();
         if (it.is_locked()) {
             return;
         }
@@ -236,17 +688,164 @@ class BPQueue {
         }
     }
 
+    /**
+     * @brief Modify key by delta, keeping the buckets sorted by less (see append_sorted())
+     *
+     * Same as modify_key() (statistics, journal, cost of the max update),
+     * except for the position of it in its new bucket.
+     *
+     * @param[in,out] it the item
+     * @param[in] delta the change of the key
+     * @param[in] less strict weak order of the items
+     */
+    template <typename Less>
+    constexpr auto modify_key_sorted(Item &it, Int delta, Less less) noexcept -> void {
+        this->counters.on_modify_key();
+        if (it.is_locked() || delta == 0) {
+            return;
+        }
+        this->record(BpqUndoOp::relink, it);
+        this->bucket[it.data.second].detach(it);
+        this->index.unmark_if_empty(this->bucket, it.data.second);
+        it.data.second = Key(it.data.second + UInt(delta));  // modular arithmetic
+        assert(it.data.second > 0);
+        assert(it.data.second <= this->high);
+        this->insert_sorted(it, less);
+        this->counters.on_relink(it.data.second);
+        if (this->max < it.data.second) {
+            this->max = it.data.second;
+        } else if (delta < 0) {
+            this->lower_max();
+        }
+    }
+
+    /**
+     * @brief Modify keys of a batch of items
+     *
+     * Equivalent to calling modify_key(*items[i], deltas[i]) for each i,
+     * except that all relinks are applied first and the max is searched
+     * only once at the end. Locked items are skipped.
+     *
+     * @param[in] items range of pointers to the items
+     * @param[in] deltas range of the changes of the keys (same length)
+     *
+     * Note that the order of items with same key will not be preserved.
+     * For Fiduccia-Mattheyses algorithm, this is a prefered behavior.
+     */
+    template <typename ItemRange, typename DeltaRange>
+    constexpr auto modify_keys(const ItemRange &items, const DeltaRange &deltas) noexcept
+        -> void {
+        auto delta = std::begin(deltas);
+        for (auto *it : items) {
+            const auto d = Int(*delta);
+            ++delta;
+            this->counters.on_modify_key();
+            if (it->is_locked() || d == 0) {
+                continue;
+            }
+            this->record(BpqUndoOp::relink, *it);
+            this->bucket[it->data.second].detach(*it);
+            this->index.unmark_if_empty(this->bucket, it->data.second);
+            it->data.second = Key(it->data.second + UInt(d));  // modular arithmetic
+            assert(it->data.second > 0);
+            assert(it->data.second <= this->high);
+            if (d > 0) {
+                this->bucket[it->data.second].appendleft(*it);  // LIFO
+            } else {
+                this->bucket[it->data.second].append(*it);  // FIFO
+            }
+            this->index.mark(it->data.second);
+            this->counters.on_relink(it->data.second);
+            if (this->max < it->data.second) {
+                this->max = it->data.second;
+            }
+        }
+        assert(delta == std::end(deltas));
+        this->lower_max();
+    }
+
     /**
      * @brief Detach the item from BPQueue
      *
      * @param[in,out] it the item
      */
     constexpr auto detach(Item &it) noexcept -> void {
-        // this->bucket[it.data.second].detach(it)
-        it.detach();
-        while (this->bucket[this->max].is_empty()) {
-            this->max -= 1;
+        this->record(BpqUndoOp::remove, it);
+        this->bucket[it.data.second].detach(it);
+        this->counters.on_detach();
+        this->index.unmark_if_empty(this->bucket, it.data.second);
+        this->lower_max();
+    }
+
+    /**
+     * @brief Get the undo log (see BpqJournal), e.g. to set its capacity
+     *
+     * @return the undo log
+     */
+    constexpr auto undo_log() noexcept -> decltype(journal) & { return this->journal; }
+
+    /**
+     * @brief Mark the current state, to roll back to it later (see rollback_to())
+     *
+     * A template only so that an explicit instantiation of the queue
+     * without journal does not instantiate it.
+     *
+     * @return uint64_t the checkpoint
+     */
+    template <typename J = Journal> constexpr auto checkpoint() const noexcept -> uint64_t {
+        static_assert(journaled, "checkpoint() requires the BpqJournal policy");
+        return this->journal.checkpoint();
+    }
+
+    /**
+     * @brief Undo all the operations made since the checkpoint
+     *
+     * The operations are undone in the reverse order, each one by
+     * restoring the links of its item directly, so that the cost is
+     * proportional to the number of operations undone. Afterward the
+     * buckets hold the same items in the same order as at the checkpoint.
+     * The popped and detached items are reinserted, hence they must not
+     * have been attached to another list in the meantime. The later
+     * checkpoints become invalid.
+     *
+     * @param[in] cp the checkpoint
+     * @return true
+     * @return false if the checkpoint is no longer in the undo log (nothing is undone)
+     */
+    template <typename J = Journal> constexpr auto rollback_to(uint64_t cp) noexcept -> bool {
+        static_assert(journaled, "rollback_to() requires the BpqJournal policy");
+        if (!this->journal.can_rollback_to(cp)) {
+            return false;
+        }
+        this->tighten();
+        while (this->journal.checkpoint() != cp) {
+            const auto entry = this->journal.pop();
+            if (entry.op == BpqUndoOp::shift) {
+                this->max = this->find_max(this->max);  // keep max + delta in the bounds
+                this->shift_buckets(Int(-static_cast<Int>(entry.key)));
+                continue;
+            }
+            auto &it = *entry.item;
+            if (entry.op != BpqUndoOp::remove) {  // attached or relinked
+                this->bucket[it.data.second].detach(it);
+                this->index.unmark_if_empty(this->bucket, it.data.second);
+                if (entry.op == BpqUndoOp::attach) {
+                    this->counters.on_detach();
+                    continue;
+                }
+                this->counters.on_relink(entry.key);
+            } else {
+                this->counters.on_attach(entry.key);
+            }
+            it.data.second = Key(entry.key);
+            this->bucket[entry.key].insert_after(*entry.prev, it);
+            this->index.mark(entry.key);
+            if (this->max < entry.key) {
+                this->max = entry.key;
+            }
         }
+        this->max = this->find_max(this->max);
+        return true;
     }
 
     /**
@@ -254,14 +853,96 @@ class BPQueue {
      *
      * @return BpqIterator
      */
-    constexpr auto begin() -> BpqIterator<Tp, Int>;
+    constexpr auto begin() -> BpqIterator<Tp, Int, Sequence, BucketIndex, Stats, Journal>;
 
     /**
      * @brief Iterator point to the end
      *
      * @return BpqIterator
      */
-    constexpr auto end() -> BpqIterator<Tp, Int>;
+    constexpr auto end() -> BpqIterator<Tp, Int, Sequence, BucketIndex, Stats, Journal>;
+
+    /**
+     * @brief View of the items with key not less than min_key
+     *
+     * Traverses the queue in descending order as begin()/end() do, but
+     * stops at the first bucket below min_key. The empty buckets are
+     * skipped with the help of the occupancy index.
+     *
+     * @param[in] min_key the smallest key to visit
+     * @return BpqRange
+     */
+    constexpr auto range(Int min_key)
+        -> BpqRange<Tp, Int, Sequence, BucketIndex, Stats, Journal> {
+        const auto floor = min_key > this->offset ? UInt(min_key - this->offset) : UInt(0);
+        return {*this, floor};
+    }
+
+    /**
+     * @brief View of the items with key not less than min_key, with prefetching
+     *
+     * Same as range(), except that its iterator prefetches the node Distance
+     * steps ahead in the current bucket, so that the cache misses of a
+     * traversal of long buckets overlap instead of being paid one at a time.
+     *
+     * @tparam Distance number of nodes ahead
+     * @param[in] min_key the smallest key to visit (all by default)
+     * @return BpqRange
+     */
+    template <size_t Distance = 8>
+    constexpr auto prefetch_range(Int min_key = std::numeric_limits<Int>::min())
+        -> BpqRange<Tp, Int, Sequence, BucketIndex, Stats, Journal, Distance> {
+        static_assert(Distance > 0, "use range() for no prefetching");
+        const auto floor = min_key > this->offset ? UInt(min_key - this->offset) : UInt(0);
+        return {*this, floor};
+    }
+
+    /**
+     * @brief Write pointers to the (at most) k items with the highest keys
+     *
+     * The items are written in the order of the traversal (descending
+     * keys) and stay in the queue. The empty buckets are skipped with the
+     * help of the occupancy index.
+     *
+     * @param[in] k the number of items
+     * @param[out] out output iterator of pointers to the items
+     * @return OutputIt the end of the output
+     */
+    template <typename OutputIt> constexpr auto top_k(size_t k, OutputIt out) -> OutputIt {
+        this->tighten();
+        for (auto key = this->max; key != 0U && k != 0U; key = this->find_max(UInt(key - 1))) {
+            for (auto &it : this->bucket[key]) {
+                if (k == 0U) {
+                    break;
+                }
+                *out = &it;
+                ++out;
+                --k;
+            }
+        }
+        return out;
+    }
+};
+
+/**
+ * @brief The list iterator Prefetch items ahead of a BpqIterator
+ *
+ * @tparam ListIterator
+ * @tparam Enabled whether Prefetch > 0
+ */
+template <typename ListIterator, bool Enabled> struct BpqLookahead {
+    ListIterator ahead;  //!< Prefetch items after curitem
+
+    constexpr explicit BpqLookahead(ListIterator ahead) noexcept : ahead{ahead} {}
+};
+
+/**
+ * @brief Nothing to store without prefetching, so that BpqIterator stays as small as before
+ *
+ * @tparam ListIterator
+ */
+template <typename ListIterator> struct BpqLookahead<ListIterator, false> {
+    constexpr explicit BpqLookahead(ListIterator /* ahead */) noexcept {}
 };
 
 /**
@@ -270,25 +951,60 @@ class BPQueue {
  * Traverse the queue in descending order.
  * Detaching a queue items may invalidate the iterator because
  * the iterator makes a copy of the current key.
+ *
+ * With Prefetch > 0, the iterator also prefetches the node Prefetch steps
+ * ahead in the current bucket (see BPQueue::prefetch_range()).
  */
-template <typename Tp, typename Int = int32_t> class BpqIterator {
+template <typename Tp, typename Int, typename Sequence, typename BucketIndex, typename Stats,
+          typename Journal, size_t Prefetch>
+class BpqIterator : private BpqLookahead<typename Sequence::value_type::iterator, (Prefetch > 0)> {
     using UInt = std::make_unsigned_t<Int>;
 
     // using value_type = Tp;
     // using key_type = Int;
-    using Item = Dllink<std::pair<Tp, UInt>>;
+    using Item = typename Sequence::value_type::node_type;
+    using Queue = BPQueue<Tp, Int, Sequence, BucketIndex, Stats, Journal>;
+    using ListIterator = typename Sequence::value_type::iterator;
+    using Lookahead = BpqLookahead<ListIterator, (Prefetch > 0)>;
 
   private:
-    BPQueue<Tp, Int> &bpq;                     //!< the priority queue
-    UInt curkey;                               //!< the current key value
-    DllIterator<std::pair<Tp, UInt>> curitem;  //!< list iterator pointed to the current item.
+    Queue &bpq;            //!< the priority queue
+    UInt curkey;           //!< the current key value
+    ListIterator curitem;  //!< list iterator pointed to the current item.
+    UInt floor;            //!< the lowest key to visit
 
     /**
      * @brief Get the reference of the current list
      *
-     * @return Item&
+     * @return Dllist&
+     */
+    constexpr auto curlist() -> typename Queue::reference { return this->bpq.bucket[this->curkey]; }
+
+    /**
+     * @brief Move ahead one step further, and prefetch its node
+     */
+    constexpr auto advance_ahead() -> void {
+        if constexpr (Prefetch > 0) {
+            if (this->ahead != this->curlist().end()) {
+                ++this->ahead;
+                if (this->ahead != this->curlist().end()) {
+                    prefetch_read(&*this->ahead);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Prefetch the first Prefetch items after curitem in the new current list
      */
-    constexpr auto curlist() -> Item & { return this->bpq.bucket[this->curkey]; }
+    constexpr auto restart_ahead() -> void {
+        if constexpr (Prefetch > 0) {
+            this->ahead = this->curitem;
+            for (auto i = Prefetch; i != 0; --i) {
+                this->advance_ahead();
+            }
+        }
+    }
 
   public:
     /**
@@ -296,9 +1012,16 @@ template <typename Tp, typename Int = int32_t> class BpqIterator {
      *
      * @param[in] bpq
      * @param[in] curkey
+     * @param[in] floor the lowest key to visit, below which the iterator jumps to the end
      */
-    constexpr BpqIterator(BPQueue<Tp, Int> &bpq, UInt curkey)
-        : bpq{bpq}, curkey{curkey}, curitem{bpq.bucket[curkey].begin()} {}
+    constexpr BpqIterator(Queue &bpq, UInt curkey, UInt floor = 0)
+        : Lookahead{bpq.bucket[curkey].begin()},
+          bpq{bpq},
+          curkey{curkey},
+          curitem{bpq.bucket[curkey].begin()},
+          floor{floor} {
+        this->restart_ahead();
+    }
 
     /**
      * @brief Move to the next item
@@ -307,11 +1030,14 @@ template <typename Tp, typename Int = int32_t> class BpqIterator {
      */
     constexpr auto operator++() -> BpqIterator & {
         ++this->curitem;
+        this->advance_ahead();
         while (this->curitem == this->curlist().end()) {
-            do {
-                this->curkey -= 1;
-            } while (this->curlist().is_empty());
+            this->curkey = this->bpq.index.find_max(this->bpq.bucket, UInt(this->curkey - 1));
+            if (this->curkey < this->floor) {
+                this->curkey = 0;  // the sentinel, i.e. end()
+            }
             this->curitem = this->curlist().begin();
+            this->restart_ahead();
         }
         return *this;
     }
@@ -353,8 +1079,11 @@ template <typename Tp, typename Int = int32_t> class BpqIterator {
  *
  * @return BpqIterator
  */
-template <typename Tp, typename Int, class Sequence>
-inline constexpr auto BPQueue<Tp, Int, Sequence>::begin() -> BpqIterator<Tp, Int> {
+template <typename Tp, typename Int, class Sequence, class BucketIndex, class Stats,
+          class Journal>
+inline constexpr auto BPQueue<Tp, Int, Sequence, BucketIndex, Stats, Journal>::begin()
+    -> BpqIterator<Tp, Int, Sequence, BucketIndex, Stats, Journal> {
+    this->tighten();
     return {*this, this->max};
 }
 
@@ -363,7 +1092,62 @@ inline constexpr auto BPQueue<Tp, Int, Sequence>::begin() -> BpqIterator<Tp, Int
  *
  * @return BpqIterator
  */
-template <typename Tp, typename Int, class Sequence>
-inline constexpr auto BPQueue<Tp, Int, Sequence>::end() -> BpqIterator<Tp, Int> {
+template <typename Tp, typename Int, class Sequence, class BucketIndex, class Stats,
+          class Journal>
+inline constexpr auto BPQueue<Tp, Int, Sequence, BucketIndex, Stats, Journal>::end()
+    -> BpqIterator<Tp, Int, Sequence, BucketIndex, Stats, Journal> {
     return {*this, 0};
 }
+
+/**
+ * @brief View of the items of a BPQueue with key not less than a bound
+ *
+ * See BPQueue::range() and BPQueue::prefetch_range().
+ */
+template <typename Tp, typename Int, typename Sequence, typename BucketIndex, typename Stats,
+          typename Journal, size_t Prefetch>
+class BpqRange {
+    using UInt = std::make_unsigned_t<Int>;
+    using Queue = BPQueue<Tp, Int, Sequence, BucketIndex, Stats, Journal>;
+    using Iterator = BpqIterator<Tp, Int, Sequence, BucketIndex, Stats, Journal, Prefetch>;
+
+    Queue &bpq;  //!< the priority queue
+    UInt floor;  //!< the lowest key to visit
+
+  public:
+    /**
+     * @brief Construct a new bpq range object
+     *
+     * @param[in] bpq
+     * @param[in] floor the lowest (internal) key to visit
+     */
+    constexpr BpqRange(Queue &bpq, UInt floor) : bpq{bpq}, floor{floor} {}
+
+    /**
+     * @brief Iterator point to the begin
+     *
+     * @return BpqIterator
+     */
+    constexpr auto begin() -> Iterator {
+        this->bpq.tighten();
+        const auto key = this->bpq.max;
+        return {this->bpq, key < this->floor ? UInt(0) : key, this->floor};
+    }
+
+    /**
+     * @brief Iterator point to the end
+     *
+     * @return BpqIterator
+     */
+    constexpr auto end() -> Iterator { return {this->bpq, UInt(0)}; }
+};
+
+#ifdef MYWHEEL_EXTERN_TEMPLATES
+// The common specializations are instantiated once, in source/mywheel_instances.cpp (see the
+// MYWHEEL_EXTERN_TEMPLATES option), instead of in every translation unit.
+extern template class Dllink<std::pair<int, uint32_t>>;
+extern template class Dllist<std::pair<int, uint32_t>>;
+extern template class DllIterator<std::pair<int, uint32_t>>;
+extern template class BPQueue<int, int32_t>;
+extern template class BpqIterator<int, int32_t>;
+#endif
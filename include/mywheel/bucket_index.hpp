@@ -0,0 +1,230 @@
+#pragma once
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint64_t
+#include <type_traits>  // for false_type, integral_constant, void_t
+#include <vector>       // for vector
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>  // for _BitScanReverse64
+#endif
+
+/**
+ * @brief Linear bucket scan (default max-tracking policy of BPQueue)
+ *
+ * Keeps no state at all. The next non-empty bucket is found by walking
+ * down the bucket array until a non-empty list is met. The walk always
+ * terminates because bucket 0 holds the sentinel. This is the original
+ * behavior of BPQueue and is the fastest choice when the key range is
+ * small.
+ */
+struct LinearBucketScan {
+    /**
+     * @brief Construct a new LinearBucketScan object
+     */
+    constexpr explicit LinearBucketScan(size_t /* num_buckets */ = 0) noexcept {}
+
+    /**
+     * @brief Record that a bucket has become non-empty (no-op)
+     */
+    constexpr auto mark(size_t /* key */) noexcept -> void {}
+
+    /**
+     * @brief Record that a bucket may have become empty (no-op)
+     */
+    template <typename Sequence>
+    constexpr auto unmark_if_empty(const Sequence & /* bucket */, size_t /* key */) noexcept
+        -> void {}
+
+    /**
+     * @brief Forget all buckets except the sentinel bucket (no-op)
+     */
+    constexpr auto clear() noexcept -> void {}
+
+    /**
+     * @brief Resize for a new number of buckets and forget them (no-op)
+     */
+    constexpr auto reset(size_t /* num_buckets */) noexcept -> void {}
+
+    /**
+     * @brief Find the highest non-empty bucket not above key
+     *
+     * @param[in] bucket the array of lists
+     * @param[in] key the starting key
+     * @return the key of the highest non-empty bucket
+     */
+    template <typename Sequence, typename UInt>
+    constexpr auto find_max(const Sequence &bucket, UInt key) const noexcept -> UInt {
+        while (bucket[key].is_empty()) {
+            key -= 1;
+        }
+        return key;
+    }
+};
+
+/**
+ * @brief Two-level occupancy bitmap (max-tracking policy of BPQueue)
+ *
+ * Bit k of the first level is set if and only if bucket k is non-empty.
+ * Bit w of the second level (summary) is set if and only if the w-th
+ * word of the first level is non-zero. Hence the next non-empty bucket
+ * is found by at most two word-wise "count leading zeros" in the common
+ * case, and by a scan over the summary words, i.e. O(range/4096), in the
+ * worst case. Bucket 0 (the sentinel bucket) is always marked, so that
+ * searches never run off the bottom.
+ *
+ * Prefer this policy when the key range is wide (e.g. a few thousands).
+ */
+class BitmapBucketIndex {
+    using Word = std::uint64_t;
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr size_t SHIFT = 6;  // log2(WORD_BITS)
+
+    std::vector<Word> words;    //!< one bit per bucket
+    std::vector<Word> summary;  //!< one bit per word of `words`
+
+    /**
+     * @brief Position of the most significant set bit
+     *
+     * Precondition: x != 0
+     */
+    static auto highest_bit(Word x) noexcept -> size_t {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long pos;
+        _BitScanReverse64(&pos, x);
+        return size_t(pos);
+#else
+        return WORD_BITS - 1 - size_t(__builtin_clzll(x));
+#endif
+    }
+
+    /**
+     * @brief Mask of the bits strictly below pos
+     */
+    static constexpr auto below(size_t pos) noexcept -> Word { return (Word(1) << pos) - 1U; }
+
+    /**
+     * @brief Mask of the bits at or below pos
+     */
+    static constexpr auto up_to(size_t pos) noexcept -> Word {
+        return ~Word(0) >> (WORD_BITS - 1U - pos);
+    }
+
+  public:
+    /**
+     * @brief Construct a new BitmapBucketIndex object
+     *
+     * @param[in] num_buckets the number of buckets (including the sentinel bucket)
+     */
+    explicit BitmapBucketIndex(size_t num_buckets = 0)
+        : words((num_buckets >> SHIFT) + 1U), summary((num_buckets >> (2 * SHIFT)) + 1U) {
+        this->mark(0);
+    }
+
+    /**
+     * @brief Record that bucket key has become non-empty
+     *
+     * @param[in] key
+     */
+    auto mark(size_t key) noexcept -> void {
+        const auto w = key >> SHIFT;
+        this->words[w] |= Word(1) << (key & (WORD_BITS - 1));
+        this->summary[w >> SHIFT] |= Word(1) << (w & (WORD_BITS - 1));
+    }
+
+    /**
+     * @brief Unmark bucket key if it has become empty
+     *
+     * @param[in] bucket the array of lists
+     * @param[in] key
+     */
+    template <typename Sequence>
+    auto unmark_if_empty(const Sequence &bucket, size_t key) noexcept -> void {
+        if (!bucket[key].is_empty()) {
+            return;
+        }
+        const auto w = key >> SHIFT;
+        this->words[w] &= ~(Word(1) << (key & (WORD_BITS - 1)));
+        if (this->words[w] == 0U) {
+            this->summary[w >> SHIFT] &= ~(Word(1) << (w & (WORD_BITS - 1)));
+        }
+    }
+
+    /**
+     * @brief Forget all buckets except the sentinel bucket
+     */
+    auto clear() noexcept -> void {
+        for (auto &w : this->words) {
+            w = 0U;
+        }
+        for (auto &s : this->summary) {
+            s = 0U;
+        }
+        this->mark(0);
+    }
+
+    /**
+     * @brief Resize for a new number of buckets and forget them
+     *
+     * The storage is reused when its capacity allows.
+     *
+     * @param[in] num_buckets the number of buckets (including the sentinel bucket)
+     */
+    auto reset(size_t num_buckets) -> void {
+        this->words.assign((num_buckets >> SHIFT) + 1U, 0U);
+        this->summary.assign((num_buckets >> (2 * SHIFT)) + 1U, 0U);
+        this->mark(0);
+    }
+
+    /**
+     * @brief Find the highest non-empty bucket not above key
+     *
+     * @param[in] bucket the array of lists (unused)
+     * @param[in] key the starting key
+     * @return the key of the highest non-empty bucket
+     */
+    template <typename Sequence, typename UInt>
+    auto find_max(const Sequence & /* bucket */, UInt key) const noexcept -> UInt {
+        auto w = size_t(key) >> SHIFT;
+        const auto bits = this->words[w] & up_to(size_t(key) & (WORD_BITS - 1));
+        if (bits != 0U) {
+            return UInt((w << SHIFT) + highest_bit(bits));
+        }
+        // No occupied bucket left in this word; consult the summary.
+        auto s = w >> SHIFT;
+        auto sbits = this->summary[s] & below(w & (WORD_BITS - 1));
+        while (sbits == 0U) {
+            s -= 1;  // bucket 0 is always marked, hence no underflow
+            sbits = this->summary[s];
+        }
+        w = (s << SHIFT) + highest_bit(sbits);
+        return UInt((w << SHIFT) + highest_bit(this->words[w]));
+    }
+};
+
+/**
+ * @brief Lazy max tracking on top of another max-tracking policy
+ *
+ * With this policy, the max of BPQueue is only an upper bound of the
+ * highest non-empty bucket: decrease_key(), modify_keys() and detach()
+ * no longer search downwards, and the search is deferred to the next
+ * popleft(), get_max(), is_empty() or begin(). Bursts of updates, where
+ * a decrease is often followed by an increase that raises the max again,
+ * then skip the scan entirely.
+ *
+ * @tparam BucketIndex the underlying policy
+ */
+template <typename BucketIndex = LinearBucketScan> struct LazyMax : BucketIndex {
+    static constexpr bool lazy = true;  //!< see is_lazy_bucket_index
+    using BucketIndex::BucketIndex;
+};
+
+/**
+ * @brief Whether a max-tracking policy is lazy (see LazyMax)
+ */
+template <typename BucketIndex, typename = void> struct is_lazy_bucket_index
+    : std::false_type {};
+
+template <typename BucketIndex>
+struct is_lazy_bucket_index<BucketIndex, std::void_t<decltype(BucketIndex::lazy)>>
+    : std::integral_constant<bool, BucketIndex::lazy> {};
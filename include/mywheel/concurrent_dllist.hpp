@@ -0,0 +1,297 @@
+#pragma once
+
+#include <atomic>   // for atomic
+#include <cassert>  // for assert
+#include <thread>   // for yield
+#include <utility>  // for std::move()
+
+// Forward declaration
+template <typename T> class ConcurrentDllist;
+
+/**
+ * @brief Spin lock of a ConcurrentDllink node
+ *
+ * Test-and-test-and-set, yielding while the lock is held by another
+ * thread. The critical sections of ConcurrentDllist are a few stores.
+ */
+class DllinkSpinLock {
+  private:
+    std::atomic<bool> flag{false};
+
+  public:
+    auto lock() noexcept -> void {
+        while (this->flag.exchange(true, std::memory_order_acquire)) {
+            while (this->flag.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    auto try_lock() noexcept -> bool {
+        return !this->flag.load(std::memory_order_relaxed)
+               && !this->flag.exchange(true, std::memory_order_acquire);
+    }
+
+    auto unlock() noexcept -> void { this->flag.store(false, std::memory_order_release); }
+};
+
+/**
+ * @brief doubly linked node of a ConcurrentDllist
+ *
+ * Same as Dllink, plus a lock. The link between two adjacent nodes is
+ * only written while holding the locks of both nodes, so the links of a
+ * node may be read while holding its own lock.
+ */
+template <typename T> class ConcurrentDllink {
+    friend ConcurrentDllist<T>;
+
+  private:
+    ConcurrentDllink *next{this}; /**< pointer to the next node */
+    ConcurrentDllink *prev{this}; /**< pointer to the previous node */
+    DllinkSpinLock mutex;         /**< guards the links of this node */
+
+  public:
+    T data{}; /**< data */
+
+    /**
+     * @brief Construct a new ConcurrentDllink object
+     *
+     * @param[in] data the data
+     */
+    explicit ConcurrentDllink(T data) noexcept : data{std::move(data)} {}
+
+    ConcurrentDllink() = default;
+    ~ConcurrentDllink() = default;
+    ConcurrentDllink(const ConcurrentDllink &) = delete;                      // don't copy
+    auto operator=(const ConcurrentDllink &) -> ConcurrentDllink & = delete;  // don't assign
+    ConcurrentDllink(ConcurrentDllink &&) = delete;
+    auto operator=(ConcurrentDllink &&) -> ConcurrentDllink & = delete;
+
+    /**
+     * @brief whether the node is in no list
+     *
+     * Only meaningful while no other thread can attach or detach it.
+     *
+     * @return true
+     * @return false
+     */
+    auto is_locked() const noexcept -> bool { return this->next == this; }
+};
+
+/**
+ * @brief doubly linked list shared between threads
+ *
+ * Concurrent append(), appendleft(), popleft(), pop() and detach() of
+ * arbitrary nodes, e.g. for a free list or a waiting list shared between
+ * a producer and consumers. Instead of one mutex around the whole list,
+ * every operation only locks the (at most three) nodes whose links it
+ * rewrites, so that operations at both ends and in the middle of a long
+ * list proceed in parallel. Only the first lock of an operation is
+ * waited for; the other ones are tried, and on failure all the locks are
+ * released and the operation starts over, so there is no deadlock.
+ *
+ * As for Dllist, the nodes are supplied by the caller. No iteration is
+ * provided, since the list may change under the iterator.
+ */
+template <typename T> class ConcurrentDllist {
+  private:
+    ConcurrentDllink<T> head;
+
+    /**
+     * @brief try to lock node, unless it is already held by the caller (i.e. it is `held`)
+     */
+    static auto try_lock(ConcurrentDllink<T> &node, const ConcurrentDllink<T> &held) noexcept
+        -> bool {
+        return &node == &held || node.mutex.try_lock();
+    }
+
+    static auto unlock(ConcurrentDllink<T> &node, const ConcurrentDllink<T> &held) noexcept
+        -> void {
+        if (&node != &held) {
+            node.mutex.unlock();
+        }
+    }
+
+    /**
+     * @brief insert the node between the locked nodes p and n
+     */
+    static auto link(ConcurrentDllink<T> &p, ConcurrentDllink<T> &node,
+                     ConcurrentDllink<T> &n) noexcept -> void {
+        node.prev = &p;
+        node.next = &n;
+        p.next = &node;
+        n.prev = &node;
+    }
+
+    /**
+     * @brief remove the locked node from between the locked nodes p and n
+     */
+    static auto unlink(ConcurrentDllink<T> &p, ConcurrentDllink<T> &node,
+                       ConcurrentDllink<T> &n) noexcept -> void {
+        p.next = &n;
+        n.prev = &p;
+        node.next = node.prev = &node;
+    }
+
+  public:
+    ConcurrentDllist() = default;
+    ~ConcurrentDllist() = default;
+    ConcurrentDllist(const ConcurrentDllist &) = delete;                      // don't copy
+    auto operator=(const ConcurrentDllist &) -> ConcurrentDllist & = delete;  // don't assign
+    ConcurrentDllist(ConcurrentDllist &&) = delete;  // the nodes point to the head
+    auto operator=(ConcurrentDllist &&) -> ConcurrentDllist & = delete;
+
+    /**
+     * @brief whether the list is empty (at the time of the call)
+     *
+     * @return true
+     * @return false
+     */
+    auto is_empty() noexcept -> bool {
+        this->head.mutex.lock();
+        const auto res = this->head.next == &this->head;
+        this->head.mutex.unlock();
+        return res;
+    }
+
+    /**
+     * @brief append the node to the back
+     *
+     * @param[in,out] node a node in no list
+     */
+    auto append(ConcurrentDllink<T> &node) noexcept -> void {
+        auto &h = this->head;
+        while (true) {
+            h.mutex.lock();
+            auto &p = *h.prev;
+            if (try_lock(p, h)) {
+                node.mutex.lock();  // not reachable yet, so never contended
+                link(p, node, h);
+                node.mutex.unlock();
+                unlock(p, h);
+                h.mutex.unlock();
+                return;
+            }
+            h.mutex.unlock();
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief append the node to the front
+     *
+     * @param[in,out] node a node in no list
+     */
+    auto appendleft(ConcurrentDllink<T> &node) noexcept -> void {
+        auto &h = this->head;
+        while (true) {
+            h.mutex.lock();
+            auto &n = *h.next;
+            if (try_lock(n, h)) {
+                node.mutex.lock();  // not reachable yet, so never contended
+                link(h, node, n);
+                node.mutex.unlock();
+                unlock(n, h);
+                h.mutex.unlock();
+                return;
+            }
+            h.mutex.unlock();
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief pop a node from the front
+     *
+     * @return ConcurrentDllink<T>* the node, or nullptr if the list is empty
+     */
+    auto popleft() noexcept -> ConcurrentDllink<T> * {
+        auto &h = this->head;
+        while (true) {
+            h.mutex.lock();
+            auto &node = *h.next;
+            if (&node == &h) {
+                h.mutex.unlock();
+                return nullptr;
+            }
+            if (node.mutex.try_lock()) {
+                auto &n = *node.next;
+                if (try_lock(n, h)) {
+                    unlink(h, node, n);
+                    unlock(n, h);
+                    node.mutex.unlock();
+                    h.mutex.unlock();
+                    return &node;
+                }
+                node.mutex.unlock();
+            }
+            h.mutex.unlock();
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief pop a node from the back
+     *
+     * @return ConcurrentDllink<T>* the node, or nullptr if the list is empty
+     */
+    auto pop() noexcept -> ConcurrentDllink<T> * {
+        auto &h = this->head;
+        while (true) {
+            h.mutex.lock();
+            auto &node = *h.prev;
+            if (&node == &h) {
+                h.mutex.unlock();
+                return nullptr;
+            }
+            if (node.mutex.try_lock()) {
+                auto &p = *node.prev;
+                if (try_lock(p, h)) {
+                    unlink(p, node, h);
+                    unlock(p, h);
+                    node.mutex.unlock();
+                    h.mutex.unlock();
+                    return &node;
+                }
+                node.mutex.unlock();
+            }
+            h.mutex.unlock();
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief detach the node from this list
+     *
+     * The node may be popped concurrently by another thread, in which case
+     * it is left alone.
+     *
+     * @param[in,out] node a node of this list, or in no list
+     * @return true if the node was detached by this call
+     * @return false if the node was in no list
+     */
+    auto detach(ConcurrentDllink<T> &node) noexcept -> bool {
+        assert(&node != &this->head);
+        while (true) {
+            node.mutex.lock();
+            if (node.is_locked()) {
+                node.mutex.unlock();
+                return false;
+            }
+            auto &p = *node.prev;
+            if (p.mutex.try_lock()) {
+                auto &n = *node.next;
+                if (try_lock(n, p)) {
+                    unlink(p, node, n);
+                    unlock(n, p);
+                    p.mutex.unlock();
+                    node.mutex.unlock();
+                    return true;
+                }
+                p.mutex.unlock();
+            }
+            node.mutex.unlock();
+            std::this_thread::yield();
+        }
+    }
+};
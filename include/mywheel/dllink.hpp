@@ -1,11 +1,38 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>  // for size_t
 #include <utility>  // for std::move()
 
+/**
+ * @brief packed layout of Dllink (the default)
+ *
+ * The links and the data are stored under `#pragma pack(push, 1)`, so that
+ * no padding is spent on the data, e.g. Dllink<std::pair<uint16_t, uint16_t>>
+ * takes 20 bytes instead of 24. The links are misaligned in an array of such
+ * nodes; see AlignedDllinkLayout (aligned_dllist.hpp) for the other choice.
+ */
+#pragma pack(push, 1)
+struct PackedDllinkLayout {
+    template <typename T> static constexpr size_t budget = 24; /**< size limit of Dllink<T> */
+
+    /**
+     * @brief storage of a node: the links and the data
+     *
+     * @tparam Node the node type
+     * @tparam T the data type
+     */
+    template <typename Node, typename T> struct Links {
+        Node *next; /**< pointer to the next node */
+        Node *prev; /**< pointer to the previous node */
+        T data;     /**< data */
+    };
+};
+#pragma pack(pop)
+
 // Forward declaration for begin() end()
-template <typename T> class Dllist;
-template <typename T> class DllIterator;
+template <typename T, typename Layout = PackedDllinkLayout> class Dllist;
+template <typename T, typename Layout = PackedDllinkLayout> class DllIterator;
 
 /**
  * @brief doubly linked node (that may also be a "head" a list)
@@ -17,34 +44,34 @@ template <typename T> class DllIterator;
  * algorithm. This saves memory and run-time to update the length
  * information. Note that this class does not own the list node. They
  * are supplied by the caller in order to better reuse the nodes.
+ *
+ * The Layout policy decides how the links and the data are laid out in
+ * memory (PackedDllinkLayout or AlignedDllinkLayout).
  */
-#pragma pack(push, 1)
-template <typename T> class Dllink {
-    friend DllIterator<T>;
-    friend Dllist<T>;
-    friend DllIterator<T>;
+template <typename T, typename Layout = PackedDllinkLayout>
+class Dllink : private Layout::template Links<Dllink<T, Layout>, T> {
+    friend DllIterator<T, Layout>;
+    friend Dllist<T, Layout>;
 
-  private:
-    Dllink *next{this}; /**< pointer to the next node */
-    Dllink *prev{this}; /**< pointer to the previous node */
+    using Base = typename Layout::template Links<Dllink<T, Layout>, T>;
 
   public:
-    T data{}; /**< data */
+    using Base::data;
 
     /**
      * @brief Construct a new Dllink object
      *
      * @param[in] data the data
      */
-    constexpr explicit Dllink(T data) noexcept : data{std::move(data)} {
-        static_assert(sizeof(Dllink) <= 24, "keep this class small");
+    constexpr explicit Dllink(T data) noexcept : Base{this, this, std::move(data)} {
+        static_assert(sizeof(Dllink) <= Layout::template budget<T>, "keep this class small");
     }
 
     /**
      * @brief Copy construct a new Dllink object (deleted intentionally)
      *
      */
-    constexpr Dllink() = default;
+    constexpr Dllink() noexcept : Dllink{T{}} {}
     ~Dllink() = default;
     Dllink(const Dllink &) = delete;                      // don't copy
     auto operator=(const Dllink &) -> Dllink & = delete;  // don't assign
@@ -90,4 +117,3 @@ template <typename T> class Dllink {
         node.prev = this;
     }
 };
-#pragma pack(pop)
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cassert>  // for assert
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
+#include <memory>   // for unique_ptr
+#include <new>      // for align_val_t, operator new
+#include <utility>  // for std::move()
+#include <vector>   // for vector
+
+#include "dllink.hpp"  // for Dllink
+
+/**
+ * @brief Distance between two nodes of a DllinkPool slab
+ *
+ * The smallest power of two not less than the node size, so that no node
+ * straddles a cache line, or a multiple of the cache line size for large
+ * nodes.
+ *
+ * @param[in] size size of the node
+ * @return size_t
+ */
+constexpr auto dllink_pool_stride(size_t size) -> size_t {
+    if (size > 64) {
+        return (size + 63) / 64 * 64;
+    }
+    auto res = size_t(1);
+    while (res < size) {
+        res *= 2;
+    }
+    return res;
+}
+
+/**
+ * @brief Pool of Dllink nodes in aligned, chunked slabs
+ *
+ * Dllink is packed (see dllink.hpp), so a std::vector of nodes may leave
+ * nodes across two cache lines. This pool hands out nodes from slabs
+ * aligned to the cache line, `Stride` bytes apart, and never moves them.
+ * The nodes can be placed in vertex-id order or in any given order, e.g.
+ * the BFS order of the hypergraph (see bfs_order()), so that the vertices
+ * updated together in BPQueue have their nodes close together. The nodes
+ * are not freed one by one: release_all() releases them all at once and
+ * keeps the slabs for reuse.
+ *
+ * @tparam T
+ * @tparam Stride distance in bytes between two consecutive nodes
+ */
+template <typename T, size_t Stride = dllink_pool_stride(sizeof(Dllink<T>))> class DllinkPool {
+    static_assert(Stride >= sizeof(Dllink<T>), "Stride must hold a node");
+
+  public:
+    static constexpr size_t alignment = 64;  //!< alignment of the slabs (a cache line)
+
+  private:
+    struct SlabDeleter {
+        auto operator()(unsigned char *slab) const noexcept -> void {
+            ::operator delete(slab, std::align_val_t{alignment});
+        }
+    };
+
+    std::vector<std::unique_ptr<unsigned char[], SlabDeleter>> slabs;
+    std::vector<uint32_t> slot_of;  //!< slot of each vertex (empty if in vertex-id order)
+    size_t shift{0};                //!< log2 of the number of nodes per slab
+    size_t num{};                   //!< number of nodes handed out
+
+    auto slot(size_t i) const noexcept -> Dllink<T> * {
+        const auto mask = (size_t(1) << this->shift) - 1;
+        auto *slab = this->slabs[i >> this->shift].get();
+        return reinterpret_cast<Dllink<T> *>(slab + (i & mask) * Stride);
+    }
+
+  public:
+    /**
+     * @brief Construct a new DllinkPool object
+     *
+     * @param[in] chunk_size number of nodes per slab (rounded up to a power of two)
+     */
+    explicit DllinkPool(size_t chunk_size = 1024) {
+        while ((size_t(1) << this->shift) < chunk_size) {
+            ++this->shift;
+        }
+    }
+
+    DllinkPool(const DllinkPool &) = delete;                      // don't copy
+    auto operator=(const DllinkPool &) -> DllinkPool & = delete;  // don't assign
+    DllinkPool(DllinkPool &&) = delete;                           // don't move
+    auto operator=(DllinkPool &&) -> DllinkPool & = delete;
+    ~DllinkPool() { this->release_all(); }
+
+    /**
+     * @brief Number of nodes handed out
+     *
+     * @return size_t
+     */
+    auto size() const noexcept -> size_t { return this->num; }
+
+    /**
+     * @brief Number of nodes that fit in the slabs allocated so far
+     *
+     * @return size_t
+     */
+    auto capacity() const noexcept -> size_t { return this->slabs.size() << this->shift; }
+
+    /**
+     * @brief Hand out a new (locked) node
+     *
+     * @param[in] data the data
+     * @return Dllink<T>&
+     */
+    auto acquire(T data = T{}) -> Dllink<T> & {
+        if (this->num == this->capacity()) {
+            auto *slab = static_cast<unsigned char *>(
+                ::operator new(Stride << this->shift, std::align_val_t{alignment}));
+            this->slabs.emplace_back(slab);
+        }
+        auto *node = new (this->slot(this->num)) Dllink<T>{std::move(data)};
+        ++this->num;
+        return *node;
+    }
+
+    /**
+     * @brief Get the i-th node handed out
+     *
+     * @param[in] i
+     * @return Dllink<T>&
+     */
+    auto operator[](size_t i) noexcept -> Dllink<T> & {
+        assert(i < this->num);
+        return *this->slot(i);
+    }
+
+    /**
+     * @brief Release all the nodes at once
+     *
+     * The slabs are kept for the nodes handed out next.
+     */
+    auto release_all() noexcept -> void {
+        for (auto i = size_t(0); i != this->num; ++i) {
+            this->slot(i)->~Dllink<T>();
+        }
+        this->num = 0;
+        this->slot_of.clear();
+    }
+
+    /**
+     * @brief Release all the nodes, then hand out one node per vertex in vertex-id order
+     *
+     * @param[in] num_vertices number of vertices
+     */
+    auto place_vertices(size_t num_vertices) -> void {
+        this->release_all();
+        for (auto v = size_t(0); v != num_vertices; ++v) {
+            this->acquire();
+        }
+    }
+
+    /**
+     * @brief Release all the nodes, then hand out one node per vertex in the given order
+     *
+     * The node of vertex order[0] comes first, then that of order[1], and so on.
+     *
+     * @param[in] order a permutation of the vertices
+     */
+    auto place_vertices(const std::vector<uint32_t> &order) -> void {
+        this->place_vertices(order.size());
+        this->slot_of.resize(order.size());
+        for (auto i = size_t(0); i != order.size(); ++i) {
+            this->slot_of[order[i]] = uint32_t(i);
+        }
+    }
+
+    /**
+     * @brief Get the node of vertex v (see place_vertices())
+     *
+     * @param[in] v the vertex
+     * @return Dllink<T>&
+     */
+    auto vertex(size_t v) noexcept -> Dllink<T> & {
+        return this->slot_of.empty() ? (*this)[v] : (*this)[this->slot_of[v]];
+    }
+};
+
+/**
+ * @brief Breadth-first order of the vertices of a (hyper)graph
+ *
+ * Every connected component is traversed from its lowest vertex, in
+ * increasing order of the lowest vertex.
+ *
+ * @tparam Neighbors callable returning a range of the neighbors of a vertex
+ * @param[in] num_vertices number of vertices
+ * @param[in] neighbors e.g. the vertices sharing a net with v
+ * @return std::vector<uint32_t> a permutation of [0, num_vertices)
+ */
+template <typename Neighbors>
+auto bfs_order(size_t num_vertices, Neighbors &&neighbors) -> std::vector<uint32_t> {
+    auto res = std::vector<uint32_t>{};
+    res.reserve(num_vertices);
+    auto visited = std::vector<bool>(num_vertices, false);
+    for (auto s = size_t(0); s != num_vertices; ++s) {
+        if (visited[s]) {
+            continue;
+        }
+        visited[s] = true;
+        res.push_back(uint32_t(s));
+        for (auto head = res.size() - 1; head != res.size(); ++head) {
+            const auto v = res[head];
+            for (const auto w : neighbors(v)) {
+                if (!visited[size_t(w)]) {
+                    visited[size_t(w)] = true;
+                    res.push_back(uint32_t(w));
+                }
+            }
+        }
+    }
+    return res;
+}
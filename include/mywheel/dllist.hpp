@@ -4,9 +4,6 @@
 
 #include "dllink.hpp"  // for Dllink
 
-// Forward declaration for begin() end()
-template <typename T> class DllIterator;
-
 /**
  * @brief doubly linked node (that may also be a "head" a list)
  *
@@ -17,13 +14,38 @@ template <typename T> class DllIterator;
  * algorithm. This saves memory and run-time to update the length
  * information. Note that this class does not own the list node. They
  * are supplied by the caller in order to better reuse the nodes.
+ *
+ * The Layout policy is the one of the nodes (see Dllink). The list is
+ * laid out as its head node, hence it needs no `#pragma pack` of its own.
  */
-#pragma pack(push, 1)
-template <typename T> class Dllist {
-    friend DllIterator<T>;
+template <typename T, typename Layout> class Dllist {
+    friend DllIterator<T, Layout>;
+
+  public:
+    using node_type = Dllink<T, Layout>;
+    using iterator = DllIterator<T, Layout>;
 
   private:
-    Dllink<T> head;
+    node_type head;
+
+    /**
+     * @brief link the chain [first, last] right after node at
+     */
+    static constexpr auto attach_chain(node_type &at, node_type &first, node_type &last) noexcept
+        -> void {
+        last.next = at.next;
+        at.next->prev = &last;
+        at.next = &first;
+        first.prev = &at;
+    }
+
+    /**
+     * @brief unlink the chain [first, last] from its list
+     */
+    static constexpr auto detach_chain(node_type &first, node_type &last) noexcept -> void {
+        first.prev->next = last.next;
+        last.next->prev = first.prev;
+    }
 
   public:
     /**
@@ -32,7 +54,7 @@ template <typename T> class Dllist {
      * @param[in] data the data
      */
     constexpr explicit Dllist(T data) noexcept : head{std::move(data)} {
-        static_assert(sizeof(Dllist) <= 24, "keep this class small");
+        static_assert(sizeof(Dllist) <= Layout::template budget<T>, "keep this class small");
     }
 
     /**
@@ -65,14 +87,21 @@ template <typename T> class Dllist {
      *
      * @param[in,out] node
      */
-    constexpr auto appendleft(Dllink<T> &node) noexcept -> void { this->head.attach(node); }
+    constexpr auto appendleft(node_type &node) noexcept -> void { this->head.attach(node); }
 
     /**
      * @brief append the node to the back
      *
      * @param[in,out] node
      */
-    constexpr auto append(Dllink<T> &node) noexcept -> void { this->head.prev->attach(node); }
+    constexpr auto append(node_type &node) noexcept -> void { this->head.prev->attach(node); }
+
+    /**
+     * @brief detach the node from this list
+     *
+     * @param[in,out] node
+     */
+    constexpr auto detach(node_type &node) noexcept -> void { node.detach(); }
 
     /**
      * @brief pop a node from the front
@@ -81,7 +110,7 @@ template <typename T> class Dllist {
      *
      * Precondition: list is not empty
      */
-    constexpr auto popleft() noexcept -> Dllink<T> & {
+    constexpr auto popleft() noexcept -> node_type & {
         auto res = this->head.next;
         res->detach();
         return *res;
@@ -94,12 +123,87 @@ template <typename T> class Dllist {
      *
      * Precondition: list is not empty
      */
-    constexpr auto pop() noexcept -> Dllink<T> & {
+    constexpr auto pop() noexcept -> node_type & {
         auto res = this->head.prev;
         res->detach();
         return *res;
     }
 
+    /**
+     * @brief move all nodes of other to the back of this list in O(1)
+     *
+     * @param[in,out] other (empty afterward)
+     */
+    constexpr auto splice_back(Dllist &other) noexcept -> void {
+        if (other.is_empty()) {
+            return;
+        }
+        auto &first = *other.head.next;
+        auto &last = *other.head.prev;
+        other.clear();
+        attach_chain(*this->head.prev, first, last);
+    }
+
+    /**
+     * @brief move all nodes of other to the front of this list in O(1)
+     *
+     * @param[in,out] other (empty afterward)
+     */
+    constexpr auto splice_front(Dllist &other) noexcept -> void {
+        if (other.is_empty()) {
+            return;
+        }
+        auto &first = *other.head.next;
+        auto &last = *other.head.prev;
+        other.clear();
+        attach_chain(this->head, first, last);
+    }
+
+    /**
+     * @brief move the nodes [first, last] to the back of this list in O(1)
+     *
+     * @param[in,out] first
+     * @param[in,out] last
+     *
+     * Precondition: first..last is a chain of (unlocked) nodes of one list,
+     * following the next links, and it contains neither head.
+     */
+    constexpr auto splice_back(node_type &first, node_type &last) noexcept -> void {
+        detach_chain(first, last);
+        attach_chain(*this->head.prev, first, last);
+    }
+
+    /**
+     * @brief move the nodes [first, last] to the front of this list in O(1)
+     *
+     * @param[in,out] first
+     * @param[in,out] last
+     *
+     * Precondition: same as splice_back(first, last)
+     */
+    constexpr auto splice_front(node_type &first, node_type &last) noexcept -> void {
+        detach_chain(first, last);
+        attach_chain(this->head, first, last);
+    }
+
+    /**
+     * @brief the node before node in this list (the head if node is the first one)
+     *
+     * @param[in] node a node of this list
+     * @return Dllink<T>&
+     */
+    constexpr auto predecessor(node_type &node) noexcept -> node_type & { return *node.prev; }
+
+    /**
+     * @brief insert the node right after node at
+     *
+     * @param[in,out] at a node of this list, or its head (see predecessor())
+     * @param[in,out] node a node in no list
+     */
+    constexpr auto insert_after(node_type &at, node_type &node) noexcept -> void {
+        at.attach(node);
+    }
+
     // For iterator
 
     /**
@@ -107,16 +211,15 @@ template <typename T> class Dllist {
      *
      * @return DllIterator
      */
-    constexpr auto begin() noexcept -> DllIterator<T>;
+    constexpr auto begin() noexcept -> DllIterator<T, Layout>;
 
     /**
      * @brief
      *
      * @return DllIterator
      */
-    constexpr auto end() noexcept -> DllIterator<T>;
+    constexpr auto end() noexcept -> DllIterator<T, Layout>;
 };
-#pragma pack(pop)
 
 /**
  * @brief list iterator
@@ -124,9 +227,9 @@ template <typename T> class Dllist {
  * List iterator. Traverse the list from the first item. Usually it is
  * safe to attach/detach list items during the iterator is active.
  */
-template <typename T> class DllIterator {
+template <typename T, typename Layout> class DllIterator {
   private:
-    Dllink<T> *cur; /**< pointer to the current item */
+    Dllink<T, Layout> *cur; /**< pointer to the current item */
 
   public:
     /**
@@ -134,7 +237,7 @@ template <typename T> class DllIterator {
      *
      * @param[in] cur
      */
-    constexpr explicit DllIterator(Dllink<T> *cur) noexcept : cur{cur} {}
+    constexpr explicit DllIterator(Dllink<T, Layout> *cur) noexcept : cur{cur} {}
 
     /**
      * @brief move to the next item
@@ -151,7 +254,7 @@ template <typename T> class DllIterator {
      *
      * @return Dllist&
      */
-    constexpr auto operator*() noexcept -> Dllink<T> & { return *this->cur; }
+    constexpr auto operator*() noexcept -> Dllink<T, Layout> & { return *this->cur; }
 
     /**
      * @brief eq operator
@@ -161,7 +264,8 @@ template <typename T> class DllIterator {
      * @return true
      * @return false
      */
-    friend auto operator==(const DllIterator &lhs, const DllIterator &rhs) noexcept -> bool {
+    friend constexpr auto operator==(const DllIterator &lhs, const DllIterator &rhs) noexcept
+        -> bool {
         return lhs.cur == rhs.cur;
     }
 
@@ -173,7 +277,8 @@ template <typename T> class DllIterator {
      * @return true
      * @return false
      */
-    friend auto operator!=(const DllIterator &lhs, const DllIterator &rhs) noexcept -> bool {
+    friend constexpr auto operator!=(const DllIterator &lhs, const DllIterator &rhs) noexcept
+        -> bool {
         return !(lhs == rhs);
     }
 };
@@ -183,8 +288,9 @@ template <typename T> class DllIterator {
  *
  * @return DllIterator
  */
-template <typename T> constexpr auto Dllist<T>::begin() noexcept -> DllIterator<T> {
-    return DllIterator<T>{this->head.next};
+template <typename T, typename Layout>
+constexpr auto Dllist<T, Layout>::begin() noexcept -> DllIterator<T, Layout> {
+    return DllIterator<T, Layout>{this->head.next};
 }
 
 /**
@@ -192,6 +298,7 @@ template <typename T> constexpr auto Dllist<T>::begin() noexcept -> DllIterator<
  *
  * @return DllIterator
  */
-template <typename T> constexpr auto Dllist<T>::end() noexcept -> DllIterator<T> {
-    return DllIterator<T>{&this->head};
+template <typename T, typename Layout>
+constexpr auto Dllist<T, Layout>::end() noexcept -> DllIterator<T, Layout> {
+    return DllIterator<T, Layout>{&this->head};
 }
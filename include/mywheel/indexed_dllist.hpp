@@ -0,0 +1,457 @@
+#pragma once
+
+#include <cassert>  // for assert
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint32_t
+#include <utility>  // for std::move()
+#include <vector>   // for vector
+
+// Forward declaration
+template <typename T> class IndexedDllist;
+template <typename T> class IndexedDllIterator;
+template <typename T> class IndexedDllPool;
+
+/**
+ * @brief doubly linked node with 32-bit links into a node pool
+ *
+ * Same as Dllink, except that the links are stored as uint32_t indices
+ * into one contiguous arena (see IndexedDllPool) instead of raw pointers.
+ * Hence Dllink<std::pair<int, uint32_t>> (24 bytes) shrinks to 16 bytes.
+ * A node is locked when its next index is `npos`. Since a node does not
+ * know the arena it lives in, detaching is done through a list handle.
+ */
+template <typename T> class IndexedDllink {
+    friend IndexedDllist<T>;
+    friend IndexedDllIterator<T>;
+    friend IndexedDllPool<T>;
+
+  public:
+    static constexpr uint32_t npos = ~uint32_t(0);  //!< "points to nowhere"
+
+  private:
+    uint32_t next{npos}; /**< index of the next node */
+    uint32_t prev{npos}; /**< index of the previous node */
+
+  public:
+    T data{}; /**< data */
+
+    /**
+     * @brief Construct a new IndexedDllink object
+     *
+     * @param[in] data the data
+     */
+    constexpr explicit IndexedDllink(T data) noexcept : data{std::move(data)} {
+        static_assert(sizeof(IndexedDllink) <= 16, "keep this class small");
+    }
+
+    constexpr IndexedDllink() = default;
+    ~IndexedDllink() = default;
+    IndexedDllink(const IndexedDllink &) = delete;                      // don't copy
+    auto operator=(const IndexedDllink &) -> IndexedDllink & = delete;  // don't assign
+    constexpr IndexedDllink(IndexedDllink &&) noexcept = default;
+    constexpr auto operator=(IndexedDllink &&) noexcept -> IndexedDllink & = delete;
+
+    /**
+     * @brief lock the node (and don't append it to any list)
+     *
+     */
+    constexpr auto lock() noexcept -> void { this->next = npos; }
+
+    /**
+     * @brief whether the node is locked
+     *
+     * @return true
+     * @return false
+     */
+    constexpr auto is_locked() const noexcept -> bool { return this->next == npos; }
+};
+
+/**
+ * @brief doubly linked list handle over a node pool
+ *
+ * A lightweight (copyable) handle made of the arena base pointer and the
+ * index of the list's head node. All handles of the same pool may
+ * attach/detach any node of that pool, so it can be used as a drop-in
+ * list type for BPQueue via IndexedDllSequence.
+ */
+template <typename T> class IndexedDllist {
+    friend IndexedDllIterator<T>;
+
+  public:
+    using node_type = IndexedDllink<T>;
+    using iterator = IndexedDllIterator<T>;
+
+  private:
+    IndexedDllink<T> *arena; /**< base of the node pool */
+    uint32_t head;           /**< index of the head node */
+
+    constexpr auto index_of(const IndexedDllink<T> &node) const noexcept -> uint32_t {
+        return static_cast<uint32_t>(&node - this->arena);
+    }
+
+    /**
+     * @brief attach node i right after node at
+     */
+    constexpr auto attach(uint32_t at, uint32_t i) const noexcept -> void {
+        auto &pos = this->arena[at];
+        auto &node = this->arena[i];
+        node.next = pos.next;
+        this->arena[pos.next].prev = i;
+        pos.next = i;
+        node.prev = at;
+    }
+
+    /**
+     * @brief move all nodes of other right after node at
+     */
+    constexpr auto splice_after(uint32_t at, const IndexedDllist &other) const noexcept -> void {
+        assert(this->arena == other.arena && this->head != other.head);
+        if (other.is_empty()) {
+            return;
+        }
+        const auto first = this->arena[other.head].next;
+        const auto last = this->arena[other.head].prev;
+        other.clear();
+        auto &pos = this->arena[at];
+        this->arena[last].next = pos.next;
+        this->arena[pos.next].prev = last;
+        pos.next = first;
+        this->arena[first].prev = at;
+    }
+
+  public:
+    /**
+     * @brief Construct a new IndexedDllist handle
+     *
+     * @param[in] arena base of the node pool
+     * @param[in] head index of the head node
+     */
+    constexpr IndexedDllist(IndexedDllink<T> *arena, uint32_t head) noexcept
+        : arena{arena}, head{head} {}
+
+    /**
+     * @brief whether the list is empty
+     *
+     * @return true
+     * @return false
+     */
+    constexpr auto is_empty() const noexcept -> bool {
+        return this->arena[this->head].next == this->head;
+    }
+
+    /**
+     * @brief reset the list
+     *
+     */
+    constexpr auto clear() const noexcept -> void {
+        this->arena[this->head].next = this->arena[this->head].prev = this->head;
+    }
+
+    /**
+     * @brief append the node to the front
+     *
+     * @param[in,out] node
+     */
+    constexpr auto appendleft(IndexedDllink<T> &node) const noexcept -> void {
+        this->attach(this->head, this->index_of(node));
+    }
+
+    /**
+     * @brief append the node to the back
+     *
+     * @param[in,out] node
+     */
+    constexpr auto append(IndexedDllink<T> &node) const noexcept -> void {
+        this->attach(this->arena[this->head].prev, this->index_of(node));
+    }
+
+    /**
+     * @brief detach a node from whichever list of the pool it is in
+     *
+     * @param[in,out] node
+     */
+    constexpr auto detach(IndexedDllink<T> &node) const noexcept -> void {
+        assert(!node.is_locked());
+        const auto n = node.next;
+        const auto p = node.prev;
+        this->arena[p].next = n;
+        this->arena[n].prev = p;
+    }
+
+    /**
+     * @brief pop a node from the front
+     *
+     * @return IndexedDllink&
+     *
+     * Precondition: list is not empty
+     */
+    constexpr auto popleft() const noexcept -> IndexedDllink<T> & {
+        auto &res = this->arena[this->arena[this->head].next];
+        this->detach(res);
+        return res;
+    }
+
+    /**
+     * @brief pop a node from the back
+     *
+     * @return IndexedDllink&
+     *
+     * Precondition: list is not empty
+     */
+    constexpr auto pop() const noexcept -> IndexedDllink<T> & {
+        auto &res = this->arena[this->arena[this->head].prev];
+        this->detach(res);
+        return res;
+    }
+
+    /**
+     * @brief move all nodes of other (of the same pool) to the back in O(1)
+     *
+     * @param[in] other (empty afterward)
+     */
+    constexpr auto splice_back(const IndexedDllist &other) const noexcept -> void {
+        this->splice_after(this->arena[this->head].prev, other);
+    }
+
+    /**
+     * @brief move all nodes of other (of the same pool) to the front in O(1)
+     *
+     * @param[in] other (empty afterward)
+     */
+    constexpr auto splice_front(const IndexedDllist &other) const noexcept -> void {
+        this->splice_after(this->head, other);
+    }
+
+    /**
+     * @brief the node before node in this list (the head if node is the first one)
+     *
+     * @param[in] node a node of this list
+     * @return IndexedDllink&
+     */
+    constexpr auto predecessor(IndexedDllink<T> &node) const noexcept -> IndexedDllink<T> & {
+        return this->arena[node.prev];
+    }
+
+    /**
+     * @brief insert the node right after node at
+     *
+     * @param[in,out] at a node of this list, or its head (see predecessor())
+     * @param[in,out] node a node in no list
+     */
+    constexpr auto insert_after(IndexedDllink<T> &at, IndexedDllink<T> &node) const noexcept
+        -> void {
+        this->attach(this->index_of(at), this->index_of(node));
+    }
+
+    // For iterator
+
+    /**
+     * @brief
+     *
+     * @return IndexedDllIterator
+     */
+    constexpr auto begin() const noexcept -> IndexedDllIterator<T> {
+        return IndexedDllIterator<T>{this->arena, this->arena[this->head].next};
+    }
+
+    /**
+     * @brief
+     *
+     * @return IndexedDllIterator
+     */
+    constexpr auto end() const noexcept -> IndexedDllIterator<T> {
+        return IndexedDllIterator<T>{this->arena, this->head};
+    }
+};
+
+/**
+ * @brief list iterator
+ *
+ * List iterator. Traverse the list from the first item. Usually it is
+ * safe to attach/detach list items during the iterator is active.
+ */
+template <typename T> class IndexedDllIterator {
+  private:
+    IndexedDllink<T> *arena; /**< base of the node pool */
+    uint32_t cur;            /**< index of the current item */
+
+  public:
+    /**
+     * @brief Construct a new indexed dll iterator object
+     *
+     * @param[in] arena
+     * @param[in] cur
+     */
+    constexpr IndexedDllIterator(IndexedDllink<T> *arena, uint32_t cur) noexcept
+        : arena{arena}, cur{cur} {}
+
+    /**
+     * @brief move to the next item
+     *
+     * @return IndexedDllIterator&
+     */
+    constexpr auto operator++() noexcept -> IndexedDllIterator & {
+        this->cur = this->arena[this->cur].next;
+        return *this;
+    }
+
+    /**
+     * @brief get the reference of the current item
+     *
+     * @return IndexedDllink&
+     */
+    constexpr auto operator*() noexcept -> IndexedDllink<T> & { return this->arena[this->cur]; }
+
+    /**
+     * @brief eq operator
+     *
+     * @param[in] lhs
+     * @param[in] rhs
+     * @return true
+     * @return false
+     */
+    friend auto operator==(const IndexedDllIterator &lhs, const IndexedDllIterator &rhs) noexcept
+        -> bool {
+        return lhs.cur == rhs.cur;
+    }
+
+    /**
+     * @brief neq operator
+     *
+     * @param[in] lhs
+     * @param[in] rhs
+     * @return true
+     * @return false
+     */
+    friend auto operator!=(const IndexedDllIterator &lhs, const IndexedDllIterator &rhs) noexcept
+        -> bool {
+        return !(lhs == rhs);
+    }
+};
+
+/**
+ * @brief Array of consecutive list heads of a pool (Sequence for BPQueue)
+ *
+ * Indexing returns an IndexedDllist handle by value. The list at index 0
+ * already holds a sentinel node, as BPQueue expects from its buckets.
+ */
+template <typename T> class IndexedDllSequence {
+  public:
+    using value_type = IndexedDllist<T>;
+    using reference = IndexedDllist<T>;
+    using const_reference = IndexedDllist<T>;
+    using size_type = size_t;
+
+  private:
+    IndexedDllink<T> *arena; /**< base of the node pool */
+    uint32_t first;          /**< index of the head node of list 0 */
+    uint32_t num;            /**< number of lists */
+
+  public:
+    /**
+     * @brief Construct a new IndexedDllSequence object
+     *
+     * @param[in] arena base of the node pool
+     * @param[in] first index of the head node of list 0
+     * @param[in] num number of lists
+     */
+    constexpr IndexedDllSequence(IndexedDllink<T> *arena, uint32_t first, uint32_t num) noexcept
+        : arena{arena}, first{first}, num{num} {}
+
+    /**
+     * @brief Get the handle of list k
+     *
+     * @param[in] k
+     * @return IndexedDllist
+     */
+    constexpr auto operator[](size_t k) const noexcept -> IndexedDllist<T> {
+        return IndexedDllist<T>{this->arena, static_cast<uint32_t>(this->first + k)};
+    }
+
+    /**
+     * @brief Number of lists
+     *
+     * @return size_t
+     */
+    constexpr auto size() const noexcept -> size_t { return this->num; }
+};
+
+/**
+ * @brief Contiguous node pool for IndexedDllink
+ *
+ * One std::vector holds both the item nodes, at [0, num_items), and the
+ * list head nodes, at [num_items, num_items + num_lists). The pool never
+ * grows, so that handles of its lists stay valid.
+ */
+template <typename T> class IndexedDllPool {
+    std::vector<IndexedDllink<T>> nodes;
+    size_t num_items;
+
+  public:
+    /**
+     * @brief Construct a new IndexedDllPool object
+     *
+     * @param[in] num_items number of item nodes
+     * @param[in] num_lists number of list heads
+     */
+    IndexedDllPool(size_t num_items, size_t num_lists)
+        : nodes(num_items + num_lists), num_items{num_items} {
+        assert(this->nodes.size() < IndexedDllink<T>::npos);
+        for (auto j = size_t(0); j != num_lists; ++j) {
+            this->list(j).clear();
+        }
+    }
+
+    IndexedDllPool(const IndexedDllPool &) = delete;                      // don't copy
+    auto operator=(const IndexedDllPool &) -> IndexedDllPool & = delete;  // don't assign
+    IndexedDllPool(IndexedDllPool &&) noexcept = default;
+    auto operator=(IndexedDllPool &&) noexcept -> IndexedDllPool & = default;
+    ~IndexedDllPool() = default;
+
+    /**
+     * @brief Get item node i
+     *
+     * @param[in] i
+     * @return IndexedDllink&
+     */
+    auto operator[](size_t i) -> IndexedDllink<T> & { return this->nodes[i]; }
+
+    /**
+     * @brief Get the index of an item node
+     *
+     * @param[in] node
+     * @return size_t
+     */
+    auto index_of(const IndexedDllink<T> &node) const -> size_t {
+        return static_cast<size_t>(&node - this->nodes.data());
+    }
+
+    /**
+     * @brief Get the handle of list j
+     *
+     * @param[in] j
+     * @return IndexedDllist
+     */
+    auto list(size_t j) -> IndexedDllist<T> {
+        return IndexedDllist<T>{this->nodes.data(), static_cast<uint32_t>(this->num_items + j)};
+    }
+
+    /**
+     * @brief Get lists [first, first + num) as buckets of a BPQueue
+     *
+     * The list first + num is sacrificed as the sentinel of bucket 0,
+     * hence num + 1 list heads are occupied.
+     *
+     * @param[in] first the first list
+     * @param[in] num number of buckets, i.e. b - a + 2
+     * @return IndexedDllSequence
+     */
+    auto buckets(size_t first, size_t num) -> IndexedDllSequence<T> {
+        assert(this->num_items + first + num < this->nodes.size());
+        auto &sentinel = this->nodes[this->num_items + first + num];
+        this->list(first).appendleft(sentinel);
+        return IndexedDllSequence<T>{this->nodes.data(),
+                                     static_cast<uint32_t>(this->num_items + first),
+                                     static_cast<uint32_t>(num)};
+    }
+};
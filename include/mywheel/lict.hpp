@@ -1,7 +1,13 @@
 #pragma once
 
+#include <algorithm>  // for min, max
+#include <cassert>    // for assert
+#include <cstdint>    // for uint32_t, uintptr_t
+#include <iterator>   // for next
 #include <py2cpp/enumerate.hpp>
 #include <py2cpp/range.hpp>
+#include <thread>   // for thread
+#include <utility>  // for std::move()
 #include <vector>
 
 namespace py {
@@ -12,27 +18,34 @@ namespace py {
      * The `Lict` class is a custom implementation of an unordered mapping with integer keys and
      * generic values, which adapts a vector to behave like a dictionary.
      *
+     * The storage can be any contiguous container with the vector interface, e.g. an ArrayView
+     * (see mapped_array.hpp) over a memory-mapped file, so that large arrays are used in place
+     * rather than copied: `Lict<T, ArrayView<const T>>` is read-only.
+     *
      * @tparam T
+     * @tparam Container storage of the values
      */
-    template <typename T> class Lict {
+    template <typename T, typename Container = std::vector<T>> class Lict {
       public:
         using key_type = size_t;
         using value_type = T;
         using iterator = py::Range<key_type>::iterator;
         using const_iterator = py::Range<key_type>::iterator;
 
+        static constexpr size_t cache_line_size = 64;  //!< see chunks()
+
       private:
         // py::Range<key_type> _rng;
-        std::vector<T> _lst;
+        Container _lst;
 
       public:
         /**
          * @brief Constructor for a dictionary-like adaptor for a vector.
          *
-         * @param[in] lst The `lst` parameter is a vector. It is used to initialize the `self.lst`
-         * attribute of the class
+         * @param[in] lst The `lst` parameter is a vector (or a view of the storage). It is used to
+         * initialize the `self.lst` attribute of the class
          */
-        explicit Lict(std::vector<T> lst) : _lst(std::move(lst)) {}
+        explicit Lict(Container lst) : _lst(std::move(lst)) {}
 
         /**
          * @brief This function allows you to access an element in a Lict object by its index.
@@ -63,7 +76,7 @@ namespace py {
          *   7
          *
          */
-        T &operator[](const key_type &key) { return this->_lst[key]; }
+        typename Container::reference operator[](const key_type &key) { return this->_lst[key]; }
 
         /**
          * @brief This function allows you to access an element in a Lict object by its index.
@@ -176,6 +189,248 @@ namespace py {
          *   (3, 6)
          */
         auto items() { return py::enumerate(this->_lst); }
+
+        /**
+         * @brief The `chunks` function splits the keys into at most `n` consecutive ranges of
+         * about the same length, for the workers of a parallel loop.
+         *
+         * Every boundary between two ranges falls on a cache line boundary of the storage, so
+         * that no two workers write to the same cache line (no false sharing), whatever
+         * sizeof(T). Hence there may be fewer than `n` ranges for small maps, or when sizeof(T)
+         * does not divide the cache line size (a boundary every cache_line_size / gcd(sizeof(T),
+         * cache_line_size) keys at most).
+         *
+         * @param[in] n The number of workers.
+         * @return The ranges of keys, in increasing order, covering [0, size()).
+         *
+         * Examples:
+         *   >>> auto a = Lict(std::vector<int>(100));
+         *   >>> for (const auto &rng : a.chunks(4)) {
+         *   ...     // hand rng to a worker
+         *   ... }
+         */
+        std::vector<py::Range<key_type>> chunks(size_t n) const {
+            auto res = std::vector<py::Range<key_type>>{};
+            const auto size = this->_lst.size();
+            if (size == 0) {
+                return res;
+            }
+            n = n == 0 ? 1 : n;
+            // A key k may start a range only if its element starts a cache line, i.e. if
+            // (addr + k * sizeof(T)) % cache_line_size == 0. Such keys repeat every `step`
+            // keys from `skew`, if any.
+            const auto addr = size_t(reinterpret_cast<std::uintptr_t>(this->_lst.data()));
+            auto skew = size_t(0);
+            while (skew != cache_line_size && (addr + skew * sizeof(T)) % cache_line_size != 0) {
+                ++skew;
+            }
+            if (skew == cache_line_size) {
+                n = 1;  // no element starts a cache line
+            }
+            auto step = size_t(1);
+            while (step * sizeof(T) % cache_line_size != 0) {
+                ++step;
+            }
+            auto first = key_type(0);
+            for (auto i = size_t(1); i < n; ++i) {
+                const auto mid = size / n * i + size % n * i / n;
+                auto last = mid <= skew ? skew : skew + (mid - skew + step - 1) / step * step;
+                last = std::min(last, size);
+                if (last > first) {
+                    res.push_back(py::range<key_type>(first, last));
+                    first = last;
+                }
+            }
+            if (first < size) {
+                res.push_back(py::range<key_type>(first, size));
+            }
+            return res;
+        }
+
+        /**
+         * @brief The `parallel_for_each_item` function calls `fn(key, value)` for every item,
+         * with the keys split across worker threads by `chunks`.
+         *
+         * The calling thread takes the first range. Each key is visited exactly once; the order
+         * is only kept within a range. `fn` must not throw, and its calls on different keys must
+         * be safe to run concurrently.
+         *
+         * @param[in] fn The function, called as `fn(key_type, T &)`.
+         * @param[in] num_workers The number of threads (0 for std::thread::hardware_concurrency).
+         *
+         * Examples:
+         *   >>> auto gain = Lict(std::vector<int>(num_vertices));
+         *   >>> gain.parallel_for_each_item([&](auto v, auto &g) { g = init_gain(v); });
+         */
+        template <typename Fn> void parallel_for_each_item(Fn &&fn, size_t num_workers = 0) {
+            if (num_workers == 0) {
+                num_workers = std::max(1U, std::thread::hardware_concurrency());
+            }
+            const auto ranges = this->chunks(num_workers);
+            auto run = [&fn, this](const py::Range<key_type> &rng) {
+                for (const auto &key : rng) {
+                    fn(key, this->_lst[key]);
+                }
+            };
+            auto workers = std::vector<std::thread>{};
+            if (ranges.size() > 1) {
+                workers.reserve(ranges.size() - 1);
+                for (auto it = std::next(ranges.begin()); it != ranges.end(); ++it) {
+                    workers.emplace_back(run, *it);
+                }
+            }
+            if (!ranges.empty()) {
+                run(ranges.front());
+            }
+            for (auto &worker : workers) {
+                worker.join();
+            }
+        }
+    };
+
+    /**
+     * @brief Lict with an O(1) clear by generation stamps
+     *
+     * The `StampedLict` class is a per-key map over [0, n) meant to be reset on every pass. Each
+     * slot carries the generation it was last written in, and a slot of an older generation reads
+     * as the default value, so that `clear()` only bumps the generation instead of rewriting all
+     * the slots. The keys written since the last `clear()` are recorded in a touched list, so that
+     * the per-pass work can be proportional to the number of touched keys rather than to n.
+     *
+     * @tparam T
+     */
+    template <typename T> class StampedLict {
+      public:
+        using key_type = size_t;
+        using value_type = T;
+        using iterator = py::Range<key_type>::iterator;
+        using const_iterator = py::Range<key_type>::iterator;
+
+      private:
+        std::vector<T> _lst;
+        std::vector<uint32_t> _stamp;
+        std::vector<key_type> _touched;
+        T _default;
+        uint32_t _generation{1};
+
+      public:
+        /**
+         * @brief Constructor for a stamped dictionary-like map over [0, n).
+         *
+         * @param[in] n The number of keys.
+         * @param[in] value The default value, which every key holds after a `clear()`.
+         */
+        explicit StampedLict(size_t n, T value = T{})
+            : _lst(n, value), _stamp(n, 0U), _default(std::move(value)) {}
+
+        /**
+         * @brief This function reads the value of a key, without bounds checking.
+         *
+         * @param[in] key The key, which must be less than `size()`.
+         *
+         * @return the value of the key, or the default value if the key has not been written
+         * since the last `clear()`.
+         *
+         * Examples:
+         *   >>> auto a = StampedLict<int>(4, -1);
+         *   >>> a[2]
+         *   -1
+         */
+        const T &operator[](const key_type &key) const {
+            assert(key < this->_lst.size());
+            return this->_stamp[key] == this->_generation ? this->_lst[key] : this->_default;
+        }
+
+        /**
+         * @brief This function gives write access to the value of a key, and marks it as touched.
+         *
+         * @param[in] key The key, which must be less than `size()`.
+         *
+         * @return a reference to the value of the key.
+         *
+         * Examples:
+         *   >>> auto a = StampedLict<int>(4, -1);
+         *   >>> a[2] = 7
+         *   >>> a[2]
+         *   7
+         */
+        T &operator[](const key_type &key) {
+            assert(key < this->_lst.size());
+            if (this->_stamp[key] != this->_generation) {
+                this->_stamp[key] = this->_generation;
+                this->_lst[key] = this->_default;
+                this->_touched.push_back(key);
+            }
+            return this->_lst[key];
+        }
+
+        /**
+         * @brief This function reads the value of a key, with bounds checking.
+         *
+         * @param[in] key The key.
+         *
+         * @return the value of the key (see `operator[]`).
+         */
+        const T &at(const key_type &key) const {
+            return this->_stamp.at(key) == this->_generation ? this->_lst[key] : this->_default;
+        }
+
+        /**
+         * @brief The `is_touched` function checks if a key has been written since the last
+         * `clear()`.
+         *
+         * @param[in] key The key, which must be less than `size()`.
+         */
+        bool is_touched(const key_type &key) const {
+            return this->_stamp[key] == this->_generation;
+        }
+
+        /**
+         * @brief This function returns the keys written since the last `clear()`, in the order of
+         * their first write.
+         */
+        const std::vector<key_type> &touched() const { return this->_touched; }
+
+        /**
+         * @brief The `clear` function resets all the keys to the default value in O(1).
+         *
+         * Only the generation is bumped. When it wraps around, which happens once every 2^32 - 1
+         * calls, the stamps are reset for real.
+         */
+        void clear() {
+            this->_touched.clear();
+            ++this->_generation;
+            if (this->_generation == 0U) {
+                this->_stamp.assign(this->_stamp.size(), 0U);
+                this->_generation = 1U;
+            }
+        }
+
+        /**
+         * @brief
+         *
+         * @return iterator
+         */
+        iterator begin() const { return py::range<key_type>(this->_lst.size()).begin(); }
+
+        /**
+         * @brief
+         *
+         * @return iterator
+         */
+        iterator end() const { return py::range<key_type>(this->_lst.size()).end(); }
+
+        /**
+         * @brief The `contains` function checks if a given key is in [0, n).
+         *
+         * @param[in] key The key.
+         */
+        bool contains(const key_type &key) const { return key < this->_lst.size(); }
+
+        /**
+         * @brief This function returns the number of keys.
+         */
+        size_t size() const { return this->_lst.size(); }
     };
 
 }  // namespace py
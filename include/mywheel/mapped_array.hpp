@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cassert>      // for assert
+#include <cstddef>      // for size_t
+#include <stdexcept>    // for out_of_range
+#include <type_traits>  // for remove_const_t
+#include <utility>      // for std::exchange()
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>     // for open, O_RDONLY, O_RDWR
+#    include <sys/mman.h>  // for mmap, munmap
+#    include <sys/stat.h>  // for fstat
+#    include <unistd.h>    // for close
+
+#    include <cerrno>        // for errno
+#    include <system_error>  // for system_error, generic_category
+#endif
+
+/**
+ * @brief Non-owning view of a contiguous array
+ *
+ * The `ArrayView` class is a pointer and a size, with the part of the
+ * std::vector interface used by py::Lict and ShiftArray, so that they can
+ * be backed by storage they don't own (e.g. a MappedFile region) without
+ * copying it: `py::Lict<T, ArrayView<T>>`. Use `ArrayView<const T>` for
+ * read-only storage. The viewed storage must outlive the view.
+ *
+ * @tparam T
+ */
+template <typename T> class ArrayView {
+  public:
+    using value_type = std::remove_const_t<T>;
+    using reference = T &;
+    using const_reference = const T &;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using size_type = size_t;
+
+  private:
+    T *_data{nullptr};
+    size_t _size{0};
+
+  public:
+    constexpr ArrayView() noexcept = default;
+
+    /**
+     * @brief Construct a new ArrayView object
+     *
+     * @param[in] data the first element
+     * @param[in] size number of elements
+     */
+    constexpr ArrayView(T *data, size_t size) noexcept : _data{data}, _size{size} {}
+
+    /**
+     * @brief Construct a view of a container with contiguous storage (e.g. std::vector)
+     *
+     * @param[in] cont the container
+     */
+    template <typename Container>
+    constexpr explicit ArrayView(Container &cont) noexcept
+        : _data{cont.data()}, _size{cont.size()} {}
+
+    constexpr auto operator[](size_t index) const noexcept -> T & {
+        assert(index < this->_size);
+        return this->_data[index];
+    }
+
+    /**
+     * @brief Access with bounds checking
+     *
+     * @param[in] index
+     * @return T&
+     */
+    auto at(size_t index) const -> T & {
+        if (index >= this->_size) {
+            throw std::out_of_range("ArrayView::at");
+        }
+        return this->_data[index];
+    }
+
+    constexpr auto data() const noexcept -> T * { return this->_data; }
+    constexpr auto size() const noexcept -> size_t { return this->_size; }
+    constexpr auto empty() const noexcept -> bool { return this->_size == 0; }
+    constexpr auto begin() const noexcept -> T * { return this->_data; }
+    constexpr auto end() const noexcept -> T * { return this->_data + this->_size; }
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+
+/**
+ * @brief Access mode of a MappedFile
+ */
+enum class MapMode {
+    read_only,      //!< the pages are shared with the page cache, and can't be written
+    read_write,     //!< the writes go to the file
+    copy_on_write,  //!< the writes are private, and copy the pages they touch
+};
+
+/**
+ * @brief Memory-mapped file (POSIX)
+ *
+ * Maps a whole file, e.g. a dump of the per-vertex weights of a netlist,
+ * so that the data is paged in on first access instead of being parsed or
+ * copied at startup, and shares its pages with the page cache instead of
+ * duplicating them in the RSS. View it as an array through view() or
+ * mutable_view(). Throws std::system_error if the file can't be mapped.
+ */
+class MappedFile {
+  private:
+    void *_addr{nullptr};
+    size_t _size{0};
+    MapMode _mode{MapMode::read_only};
+
+    [[noreturn]] static auto fail(const char *what) -> void {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+  public:
+    /**
+     * @brief Map a file
+     *
+     * @param[in] path path of the file
+     * @param[in] mode access mode
+     */
+    explicit MappedFile(const char *path, MapMode mode = MapMode::read_only) : _mode{mode} {
+        const auto fd = ::open(path, mode == MapMode::read_write ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            fail("MappedFile: open");
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail("MappedFile: fstat");
+        }
+        this->_size = static_cast<size_t>(st.st_size);
+        if (this->_size != 0) {
+            const auto prot = mode == MapMode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            const auto flags = mode == MapMode::copy_on_write ? MAP_PRIVATE : MAP_SHARED;
+            this->_addr = ::mmap(nullptr, this->_size, prot, flags, fd, 0);
+            if (this->_addr == MAP_FAILED) {
+                this->_addr = nullptr;
+                ::close(fd);
+                fail("MappedFile: mmap");
+            }
+        }
+        ::close(fd);  // the mapping keeps the file open
+    }
+
+    MappedFile(const MappedFile &) = delete;                      // don't copy
+    auto operator=(const MappedFile &) -> MappedFile & = delete;  // don't assign
+
+    MappedFile(MappedFile &&other) noexcept
+        : _addr{std::exchange(other._addr, nullptr)},
+          _size{std::exchange(other._size, 0)},
+          _mode{other._mode} {}
+
+    auto operator=(MappedFile &&other) noexcept -> MappedFile & {
+        if (this != &other) {
+            this->unmap();
+            this->_addr = std::exchange(other._addr, nullptr);
+            this->_size = std::exchange(other._size, 0);
+            this->_mode = other._mode;
+        }
+        return *this;
+    }
+
+    ~MappedFile() { this->unmap(); }
+
+    /**
+     * @brief Size of the file in bytes
+     *
+     * @return size_t
+     */
+    auto size() const noexcept -> size_t { return this->_size; }
+
+    auto mode() const noexcept -> MapMode { return this->_mode; }
+
+    /**
+     * @brief View the file as a read-only array of U
+     *
+     * Trailing bytes that don't make a whole U are left out.
+     *
+     * @tparam U a trivially copyable type
+     * @return ArrayView<const U>
+     */
+    template <typename U> auto view() const noexcept -> ArrayView<const U> {
+        return ArrayView<const U>{static_cast<const U *>(this->_addr), this->_size / sizeof(U)};
+    }
+
+    /**
+     * @brief View the file as a writable array of U
+     *
+     * Precondition: the file is not mapped read-only
+     *
+     * @tparam U a trivially copyable type
+     * @return ArrayView<U>
+     */
+    template <typename U> auto mutable_view() noexcept -> ArrayView<U> {
+        assert(this->_mode != MapMode::read_only);
+        return ArrayView<U>{static_cast<U *>(this->_addr), this->_size / sizeof(U)};
+    }
+
+  private:
+    auto unmap() noexcept -> void {
+        if (this->_addr != nullptr) {
+            ::munmap(this->_addr, this->_size);
+            this->_addr = nullptr;
+        }
+    }
+};
+
+#endif
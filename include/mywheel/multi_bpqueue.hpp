@@ -0,0 +1,276 @@
+#pragma once
+
+#include <cassert>      // for assert
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t, uint32_t
+#include <type_traits>  // for make_unsigned_t
+#include <utility>      // for pair
+#include <vector>       // for vector
+
+#include "bpqueue.hpp"  // for BPQueue
+
+/**
+ * @brief Non-owning view of consecutive lists (Sequence for BPQueue)
+ *
+ * @tparam List
+ */
+template <typename List> class ListSlice {
+  public:
+    using value_type = List;
+    using reference = List &;
+    using const_reference = List &;
+    using size_type = size_t;
+
+  private:
+    List *first; /**< the first list */
+    size_t num;  /**< number of lists */
+
+  public:
+    /**
+     * @brief Construct a new ListSlice object
+     *
+     * @param[in] first the first list
+     * @param[in] num number of lists
+     */
+    constexpr ListSlice(List *first, size_t num) noexcept : first{first}, num{num} {}
+
+    /**
+     * @brief Get list k
+     *
+     * @param[in] k
+     * @return List&
+     */
+    constexpr auto operator[](size_t k) const noexcept -> List & { return this->first[k]; }
+
+    /**
+     * @brief Number of lists
+     *
+     * @return size_t
+     */
+    constexpr auto size() const noexcept -> size_t { return this->num; }
+};
+
+/**
+ * @brief One bounded priority queue per part, with a global max
+ *
+ * For k-way Fiduccia-Mattheyses, the gains of moving a vertex to each
+ * target part are kept in k BPQueues. The buckets of all k queues are
+ * carved out of one shared array. A tournament (winner) tree over the
+ * max keys of the queues is updated incrementally in O(log k) on every
+ * modification, so that the global max is available in O(1) instead of
+ * scanning all k queues. Ties are won by the lower part.
+ *
+ * All updates must go through this class (rather than through the
+ * underlying queues) in order to keep the tree up to date.
+ *
+ * @tparam Tp
+ * @tparam Int
+ * @tparam BucketIndex max-tracking policy of each queue
+ */
+template <typename Tp, typename Int = int32_t, typename BucketIndex = LinearBucketScan>
+class MultiBPQueue {
+    using UInt = std::make_unsigned_t<Int>;
+    using List = Dllist<std::pair<Tp, UInt>>;
+    using Item = Dllink<std::pair<Tp, UInt>>;
+
+  public:
+    using queue_type = BPQueue<Tp, Int, ListSlice<List>, BucketIndex>;
+
+  private:
+    std::vector<List> lists;         //!< buckets of all queues
+    std::vector<Item> sentinels;     //!< sentinel of each queue
+    std::vector<queue_type> queues;  //!< queue of each part
+    std::vector<Int> tops;           //!< max key of each leaf (padded)
+    std::vector<uint32_t> tree;      //!< winner tree, leaves at [leaves, 2 * leaves)
+    size_t leaves{1};                //!< number of leaves, a power of two
+    Int offset;                      //!< a - 1, i.e. the max of an empty queue
+
+    constexpr auto winner(uint32_t p, uint32_t q) const noexcept -> uint32_t {
+        return this->tops[q] > this->tops[p] ? q : p;
+    }
+
+    /**
+     * @brief Replay the matches on the path from leaf p to the root
+     */
+    auto update(size_t p) noexcept -> void {
+        this->tops[p] = this->queues[p].get_max();
+        for (auto i = (this->leaves + p) / 2; i != 0; i /= 2) {
+            this->tree[i] = this->winner(this->tree[2 * i], this->tree[2 * i + 1]);
+        }
+    }
+
+  public:
+    /**
+     * @brief Construct a new MultiBPQueue object
+     *
+     * @param[in] a lower bound
+     * @param[in] b upper bound
+     * @param[in] num_parts number of queues (k)
+     */
+    MultiBPQueue(Int a, Int b, size_t num_parts)
+        : lists(num_parts * (static_cast<UInt>(b - a) + 2U)),
+          sentinels(num_parts),
+          offset(a - 1) {
+        assert(a <= b);
+        assert(num_parts > 0);
+        const auto num_buckets = static_cast<size_t>(static_cast<UInt>(b - a) + 2U);
+        this->queues.reserve(num_parts);  // no reallocation: queues stay in place
+        for (auto p = size_t(0); p != num_parts; ++p) {
+            auto slice = ListSlice<List>{&this->lists[p * num_buckets], num_buckets};
+            slice[0].appendleft(this->sentinels[p]);  // sentinel
+            this->queues.emplace_back(a, b, slice);
+        }
+        while (this->leaves < num_parts) {
+            this->leaves *= 2;
+        }
+        this->tops.assign(this->leaves, this->offset);
+        this->tree.resize(2 * this->leaves);
+        for (auto i = size_t(0); i != this->leaves; ++i) {
+            this->tree[this->leaves + i] = uint32_t(i);
+        }
+        for (auto i = this->leaves - 1; i != 0; --i) {
+            this->tree[i] = this->winner(this->tree[2 * i], this->tree[2 * i + 1]);
+        }
+    }
+
+    MultiBPQueue(const MultiBPQueue &) = delete;                      // don't copy
+    auto operator=(const MultiBPQueue &) -> MultiBPQueue & = delete;  // don't assign
+    MultiBPQueue(MultiBPQueue &&) = delete;  // the queues refer to the shared buckets
+    auto operator=(MultiBPQueue &&) -> MultiBPQueue & = delete;
+    ~MultiBPQueue() = default;
+
+    /**
+     * @brief Number of parts
+     *
+     * @return size_t
+     */
+    auto num_parts() const noexcept -> size_t { return this->queues.size(); }
+
+    /**
+     * @brief Get the queue of part p (read-only)
+     *
+     * @param[in] p the part
+     * @return const queue_type&
+     */
+    auto queue(size_t p) const noexcept -> const queue_type & { return this->queues[p]; }
+
+    /**
+     * @brief Whether all the queues are empty
+     *
+     * @return true
+     * @return false
+     */
+    auto is_empty() const noexcept -> bool { return this->get_max() == this->offset; }
+
+    /**
+     * @brief Get the global max value
+     *
+     * @return Int maximum value, or a - 1 if all the queues are empty
+     */
+    auto get_max() const noexcept -> Int { return this->tops[this->tree[1]]; }
+
+    /**
+     * @brief Get the part holding the global max (the lowest one on ties)
+     *
+     * @return size_t
+     */
+    auto get_max_part() const noexcept -> size_t { return this->tree[1]; }
+
+    /**
+     * @brief Clear all the queues
+     */
+    auto clear() noexcept -> void {
+        for (auto p = size_t(0); p != this->queues.size(); ++p) {
+            this->queues[p].clear();
+            this->update(p);
+        }
+    }
+
+    /**
+     * @brief Append item with external key to the front of queue p
+     *
+     * @param[in] p the part
+     * @param[in,out] it the item
+     * @param[in] k the key
+     */
+    auto appendleft(size_t p, Item &it, Int k) noexcept -> void {
+        this->queues[p].appendleft(it, k);
+        this->update(p);
+    }
+
+    /**
+     * @brief Append item with external key to queue p
+     *
+     * @param[in] p the part
+     * @param[in,out] it the item
+     * @param[in] k the key
+     */
+    auto append(size_t p, Item &it, Int k) noexcept -> void {
+        this->queues[p].append(it, k);
+        this->update(p);
+    }
+
+    /**
+     * @brief Pop node with the highest key from queue p
+     *
+     * @param[in] p the part
+     * @return Item&
+     */
+    auto popleft(size_t p) noexcept -> Item & {
+        auto &res = this->queues[p].popleft();
+        this->update(p);
+        return res;
+    }
+
+    /**
+     * @brief Pop node with the highest key over all the queues
+     *
+     * @return std::pair<size_t, Item *> the part and the item
+     *
+     * Precondition: not all the queues are empty
+     */
+    auto pop_global_max() noexcept -> std::pair<size_t, Item *> {
+        assert(!this->is_empty());
+        const auto p = this->get_max_part();
+        return {p, &this->popleft(p)};
+    }
+
+    /**
+     * @brief Modify key by delta of an item of queue p
+     *
+     * @param[in] p the part
+     * @param[in,out] it the item
+     * @param[in] delta the change of the key
+     */
+    auto modify_key(size_t p, Item &it, Int delta) noexcept -> void {
+        this->queues[p].modify_key(it, delta);
+        this->update(p);
+    }
+
+    /**
+     * @brief Modify keys of a batch of items of queue p
+     *
+     * The tree is updated once for the whole batch.
+     *
+     * @param[in] p the part
+     * @param[in] items range of pointers to the items
+     * @param[in] deltas range of the changes of the keys
+     */
+    template <typename ItemRange, typename DeltaRange>
+    auto modify_keys(size_t p, const ItemRange &items, const DeltaRange &deltas) noexcept
+        -> void {
+        this->queues[p].modify_keys(items, deltas);
+        this->update(p);
+    }
+
+    /**
+     * @brief Detach an item from queue p
+     *
+     * @param[in] p the part
+     * @param[in,out] it the item
+     */
+    auto detach(size_t p, Item &it) noexcept -> void {
+        this->queues[p].detach(it);
+        this->update(p);
+    }
+};
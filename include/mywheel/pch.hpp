@@ -0,0 +1,12 @@
+#pragma once
+
+// The headers of mywheel (and their py2cpp and standard dependencies), to be precompiled by the
+// MYWHEEL_USE_PCH option of CMake or the pch option of xmake.
+#include "array_like.hpp"
+#include "bpqueue.hpp"
+#include "dllist.hpp"
+#include "robin.hpp"
+
+#if __has_include(<py2cpp/range.hpp>)  // lict.hpp needs py2cpp, which the consumer may lack
+#    include "lict.hpp"
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <type_traits>  // for is_constant_evaluated
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+#    include <xmmintrin.h>  // for _mm_prefetch
+#endif
+
+/**
+ * @brief Whether the call is evaluated at compile time
+ *
+ * Falls back to true (i.e. never prefetch) where the compiler cannot tell.
+ *
+ * @return true
+ * @return false
+ */
+constexpr auto prefetch_is_constant_evaluated() noexcept -> bool {
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif (defined(__GNUC__) && __GNUC__ >= 9) || defined(__clang__) \
+    || (defined(_MSC_VER) && _MSC_VER >= 1925)
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+}
+
+/**
+ * @brief Hint that addr will be read soon (no-op where not supported)
+ *
+ * Usable in constant expressions, where it does nothing.
+ *
+ * @param[in] addr
+ */
+constexpr auto prefetch_read(const void *addr) noexcept -> void {
+    if (prefetch_is_constant_evaluated()) {
+        return;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char *>(addr), _MM_HINT_T0);
+#else
+    (void)addr;
+#endif
+}
+
+/**
+ * @brief Hint that addr will be written soon (no-op where not supported)
+ *
+ * Usable in constant expressions, where it does nothing.
+ *
+ * @param[in] addr
+ */
+constexpr auto prefetch_write(const void *addr) noexcept -> void {
+    if (prefetch_is_constant_evaluated()) {
+        return;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr, 1, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char *>(addr), _MM_HINT_T0);
+#else
+    (void)addr;
+#endif
+}
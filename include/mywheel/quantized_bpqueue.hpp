@@ -0,0 +1,396 @@
+#pragma once
+
+#include <cassert>      // for assert
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t, int64_t, uint64_t
+#include <type_traits>  // for make_unsigned_t, is_integral
+#include <utility>      // for pair
+#include <vector>       // for vector
+
+#include "bucket_index.hpp"  // for LinearBucketScan
+#include "dllist.hpp"        // for Dllink, Dllist
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>  // for _BitScanReverse64
+#endif
+
+/**
+ * @brief Number of bits needed to represent x (0 for x == 0)
+ */
+inline auto quantizer_bit_length(uint64_t x) noexcept -> unsigned {
+    if (x == 0U) {
+        return 0U;
+    }
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long pos;
+    _BitScanReverse64(&pos, x);
+    return unsigned(pos) + 1U;
+#else
+    return 64U - unsigned(__builtin_clzll(x));
+#endif
+}
+
+/**
+ * @brief Linear key quantizer (default of QuantizedBPQueue)
+ *
+ * Maps the keys [a..b] onto buckets 1..n of equal width 2^shift, with
+ * the smallest shift such that n does not exceed the requested number of
+ * buckets. Two keys in the same bucket differ by less than 2^shift.
+ *
+ * @tparam Int
+ */
+template <typename Int = int32_t> class LinearQuantizer {
+    Int a;
+    unsigned shift{0};
+
+  public:
+    /**
+     * @brief Construct a new LinearQuantizer object
+     *
+     * @param[in] a lower bound
+     * @param[in] b upper bound
+     * @param[in] num_buckets max number of buckets
+     */
+    LinearQuantizer(Int a, Int b, size_t num_buckets) : a{a} {
+        assert(a <= b && num_buckets > 0);
+        const auto range = uint64_t(int64_t(b) - int64_t(a));  // keys are 0..range
+        while ((range >> this->shift) >= num_buckets) {
+            ++this->shift;
+        }
+    }
+
+    /**
+     * @brief Bucket of key, in 1..num_buckets(), non-decreasing in key
+     */
+    auto operator()(Int key) const noexcept -> size_t {
+        return size_t(uint64_t(int64_t(key) - int64_t(this->a)) >> this->shift) + 1U;
+    }
+
+    /**
+     * @brief Bound of the difference of two keys in the same bucket
+     *
+     * @return uint64_t 2^shift - 1
+     */
+    auto max_error() const noexcept -> uint64_t { return (uint64_t(1) << this->shift) - 1U; }
+};
+
+/**
+ * @brief Logarithmic key quantizer
+ *
+ * Maps a key g to a bucket by the leading `m` bits of |g|, as a floating
+ * point number with an m-bit mantissa does: keys with |g| < 2^m get their
+ * own bucket, and a larger key shares its bucket only with keys within a
+ * relative distance of 2^(1 - m). The largest m such that the number of
+ * buckets does not exceed the requested one is used (at least 1, i.e. one
+ * bucket per power of two). This keeps the small gains, which are the
+ * common ones in FM, exact.
+ *
+ * @tparam Int
+ */
+template <typename Int = int32_t> class LogQuantizer {
+    unsigned m{1};   //!< mantissa bits
+    int64_t base{};  //!< code of a, minus 1
+
+    /**
+     * @brief Monotone code of x >= 0
+     */
+    static auto code(uint64_t x, unsigned m) noexcept -> int64_t {
+        if (x < (uint64_t(1) << m)) {
+            return int64_t(x);
+        }
+        const auto e = quantizer_bit_length(x) - m;
+        return int64_t((uint64_t(1) << m) + uint64_t(e - 1U) * (uint64_t(1) << (m - 1U))
+                       + ((x >> e) - (uint64_t(1) << (m - 1U))));
+    }
+
+    /**
+     * @brief Monotone code of any key, symmetric around 0
+     */
+    static auto signed_code(Int key, unsigned m) noexcept -> int64_t {
+        if (key >= 0) {
+            return code(uint64_t(key), m);
+        }
+        return -1 - code(uint64_t(-(int64_t(key) + 1)), m);
+    }
+
+  public:
+    /**
+     * @brief Construct a new LogQuantizer object
+     *
+     * @param[in] a lower bound
+     * @param[in] b upper bound
+     * @param[in] num_buckets max number of buckets
+     */
+    LogQuantizer(Int a, Int b, size_t num_buckets) {
+        assert(a <= b && num_buckets > 0);
+        auto count = [a, b](unsigned m) {
+            return uint64_t(signed_code(b, m) - signed_code(a, m)) + 1U;
+        };
+        while (this->m + 1U < 8 * sizeof(Int) && count(this->m + 1U) <= num_buckets) {
+            ++this->m;
+        }
+        this->base = signed_code(a, this->m) - 1;
+    }
+
+    /**
+     * @brief Bucket of key, in 1..num_buckets(), non-decreasing in key
+     */
+    auto operator()(Int key) const noexcept -> size_t {
+        return size_t(signed_code(key, this->m) - this->base);
+    }
+
+    /**
+     * @brief Number of mantissa bits
+     *
+     * @return unsigned
+     */
+    auto mantissa_bits() const noexcept -> unsigned { return this->m; }
+};
+
+/**
+ * @brief Bounded priority queue over coarse buckets
+ *
+ * Same interface as BPQueue, for key ranges [a..b] too wide for one
+ * bucket per key (e.g. millions, on weighted hypergraphs). The keys are
+ * mapped by the Quantizer onto at most `num_buckets` buckets, so that the
+ * memory is proportional to the number of buckets rather than to b - a.
+ * Each item keeps its exact key, and modify_key() only relinks it when
+ * its bucket changes.
+ *
+ * Ordering guarantees:
+ * - Items in different buckets are in exact order: the quantizers are
+ *   non-decreasing, so a higher bucket only holds higher keys.
+ * - popleft() is O(1) (plus the search of the next non-empty bucket) and
+ *   returns an item of the highest bucket, whose key is below the max key
+ *   by at most the width of that bucket: LinearQuantizer::max_error()
+ *   with LinearQuantizer, or a relative 2^(1 - m) of the max with
+ *   LogQuantizer (none for |key| < 2^m). Within a bucket, the items are
+ *   in the order of the list operations (LIFO on key increase, FIFO on
+ *   decrease), as in BPQueue.
+ * - get_max() and popleft_exact() are exact, at the cost of a scan of the
+ *   highest bucket.
+ *
+ * @tparam Tp
+ * @tparam Int
+ * @tparam Quantizer LinearQuantizer or LogQuantizer
+ * @tparam BucketIndex max-tracking policy (see BPQueue)
+ */
+template <typename Tp, typename Int = int32_t, typename Quantizer = LinearQuantizer<Int>,
+          typename BucketIndex = LinearBucketScan>
+class QuantizedBPQueue {
+    using UInt = std::make_unsigned_t<Int>;
+    using List = Dllist<std::pair<Tp, UInt>>;
+    using Item = Dllink<std::pair<Tp, UInt>>;
+
+    Item sentinel{};           //!< sentinel
+    Quantizer quantize;        //!< key to bucket
+    std::vector<List> bucket;  //!< bucket, array of lists
+    BucketIndex index;         //!< occupancy index of bucket
+    size_t max{};              //!< highest non-empty bucket
+    Int offset;                //!< a - 1
+
+    auto key_of(const Item &it) const noexcept -> Int {
+        return Int(this->offset + Int(it.data.second));
+    }
+
+    auto bucket_of(const Item &it) const noexcept -> size_t {
+        return this->quantize(this->key_of(it));
+    }
+
+    /**
+     * @brief Item with the highest key in bucket k (the first one on ties)
+     */
+    auto top_item(size_t k) noexcept -> Item & {
+        auto *res = &*this->bucket[k].begin();
+        for (auto &it : this->bucket[k]) {
+            if (it.data.second > res->data.second) {
+                res = &it;
+            }
+        }
+        return *res;
+    }
+
+    auto unlink(Item &it) noexcept -> void {
+        const auto k = this->bucket_of(it);
+        this->bucket[k].detach(it);
+        this->index.unmark_if_empty(this->bucket, k);
+    }
+
+    auto lower_max() noexcept -> void { this->max = this->index.find_max(this->bucket, this->max); }
+
+  public:
+    /**
+     * @brief Construct a new QuantizedBPQueue object
+     *
+     * @param[in] a lower bound
+     * @param[in] b upper bound
+     * @param[in] num_buckets max number of buckets, e.g. 2^k
+     */
+    QuantizedBPQueue(Int a, Int b, size_t num_buckets)
+        : quantize(a, b, num_buckets),
+          bucket(this->quantize(b) + 1U),
+          index(this->quantize(b) + 1U),
+          offset(Int(a - 1)) {
+        static_assert(std::is_integral<Int>::value, "bucket's key must be an integer");
+        assert(this->bucket.size() <= num_buckets + 1U);
+        this->bucket[0].appendleft(this->sentinel);  // sentinel
+    }
+
+    QuantizedBPQueue(const QuantizedBPQueue &) = delete;                      // don't copy
+    auto operator=(const QuantizedBPQueue &) -> QuantizedBPQueue & = delete;  // don't assign
+    QuantizedBPQueue(QuantizedBPQueue &&) noexcept = default;
+    auto operator=(QuantizedBPQueue &&) noexcept -> QuantizedBPQueue & = default;
+    ~QuantizedBPQueue() = default;
+
+    /**
+     * @brief Number of buckets (without the sentinel bucket)
+     *
+     * @return size_t
+     */
+    auto num_buckets() const noexcept -> size_t { return this->bucket.size() - 1U; }
+
+    /**
+     * @brief Get the quantizer
+     *
+     * @return const Quantizer&
+     */
+    auto quantizer() const noexcept -> const Quantizer & { return this->quantize; }
+
+    /**
+     * @brief Whether the queue is empty.
+     *
+     * @return true
+     * @return false
+     */
+    auto is_empty() const noexcept -> bool { return this->max == 0U; }
+
+    /**
+     * @brief Get the key of an item
+     *
+     * @param[in] it the item
+     * @return Int
+     */
+    auto get_key(const Item &it) const noexcept -> Int { return this->key_of(it); }
+
+    /**
+     * @brief Get the exact max value (scans the highest bucket)
+     *
+     * @return Int maximum value, or a - 1 if empty
+     */
+    auto get_max() noexcept -> Int {
+        return this->max == 0U ? this->offset : this->key_of(this->top_item(this->max));
+    }
+
+    /**
+     * @brief Clear reset the PQ
+     */
+    auto clear() noexcept -> void {
+        while (this->max > 0) {
+            this->bucket[this->max].clear();
+            this->max -= 1;
+        }
+        this->index.clear();
+    }
+
+    /**
+     * @brief Append item with external key to the front of its bucket
+     *
+     * @param[in,out] it the item
+     * @param[in] k the key
+     */
+    auto appendleft(Item &it, Int k) noexcept -> void {
+        assert(k > this->offset);
+        it.data.second = UInt(k - this->offset);
+        const auto b = this->quantize(k);
+        this->bucket[b].appendleft(it);
+        this->index.mark(b);
+        if (this->max < b) {
+            this->max = b;
+        }
+    }
+
+    /**
+     * @brief Append item with external key to the back of its bucket
+     *
+     * @param[in,out] it the item
+     * @param[in] k the key
+     */
+    auto append(Item &it, Int k) noexcept -> void {
+        assert(k > this->offset);
+        it.data.second = UInt(k - this->offset);
+        const auto b = this->quantize(k);
+        this->bucket[b].append(it);
+        this->index.mark(b);
+        if (this->max < b) {
+            this->max = b;
+        }
+    }
+
+    /**
+     * @brief Pop an item of the highest bucket (see the ordering guarantees)
+     *
+     * @return Item&
+     */
+    auto popleft() noexcept -> Item & {
+        auto &res = this->bucket[this->max].popleft();
+        this->index.unmark_if_empty(this->bucket, this->max);
+        this->lower_max();
+        return res;
+    }
+
+    /**
+     * @brief Pop an item with the highest key (scans the highest bucket)
+     *
+     * @return Item&
+     */
+    auto popleft_exact() noexcept -> Item & {
+        auto &res = this->top_item(this->max);
+        this->detach(res);
+        return res;
+    }
+
+    /**
+     * @brief Modify key by delta
+     *
+     * The item is only relinked if it changes bucket: LIFO on increase,
+     * FIFO on decrease, as in BPQueue.
+     *
+     * @param[in,out] it the item
+     * @param[in] delta the change of the key
+     */
+    auto modify_key(Item &it, Int delta) noexcept -> void {
+        if (it.is_locked() || delta == 0) {
+            return;
+        }
+        const auto old_bucket = this->bucket_of(it);
+        it.data.second = UInt(it.data.second + UInt(delta));  // modular arithmetic
+        const auto b = this->bucket_of(it);
+        assert(b > 0 && b < this->bucket.size());
+        if (b == old_bucket) {
+            return;
+        }
+        this->bucket[old_bucket].detach(it);
+        this->index.unmark_if_empty(this->bucket, old_bucket);
+        if (delta > 0) {
+            this->bucket[b].appendleft(it);  // LIFO
+        } else {
+            this->bucket[b].append(it);  // FIFO
+        }
+        this->index.mark(b);
+        if (this->max < b) {
+            this->max = b;
+        } else {
+            this->lower_max();
+        }
+    }
+
+    /**
+     * @brief Detach the item from the queue
+     *
+     * @param[in,out] it the item
+     */
+    auto detach(Item &it) noexcept -> void {
+        this->unlink(it);
+        this->lower_max();
+    }
+};
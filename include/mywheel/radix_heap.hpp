@@ -0,0 +1,235 @@
+#pragma once
+
+#include <cassert>      // for assert
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t, uint64_t
+#include <type_traits>  // for make_unsigned_t, is_integral
+#include <utility>      // for pair
+#include <vector>       // for vector
+
+#include "dllist.hpp"  // for Dllink, Dllist
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>  // for _BitScanReverse64
+#endif
+
+/**
+ * @brief Monotone priority queue (radix heap)
+ *
+ * Same interface as BPQueue, for the passes whose popped keys never
+ * increase (e.g. boundary BFS, slack-based scheduling), over key ranges
+ * [a..b] too wide for a bucket per key. The items are kept in one Dllist
+ * per bit of the key type, instead of one per key: bucket i holds the
+ * items whose distance to the last popped key first differs from it at
+ * bit i - 1, and bucket 0 those equal to it. popleft() only redistributes
+ * a bucket when bucket 0 runs empty, and an item can only move down, so
+ * the cost is O(log C) amortized per item, with C = b - a, and the memory
+ * is O(log C) besides the nodes. Ties are popped in FIFO order.
+ *
+ * All the keys attached (or modified) must not be greater than the last
+ * popped key, and must be inside the bounds.
+ *
+ * @tparam Tp
+ * @tparam Int
+ */
+template <typename Tp, typename Int = int32_t> class RadixHeap {
+    using UInt = std::make_unsigned_t<Int>;
+    using List = Dllist<std::pair<Tp, UInt>>;
+    using Item = Dllink<std::pair<Tp, UInt>>;
+
+    static constexpr size_t num_buckets = 8 * sizeof(UInt) + 1;
+
+    std::vector<List> bucket;  //!< bucket, array of lists
+    UInt last{};               //!< distance of the last popped key from b
+    size_t num{};              //!< number of items
+    Int upper;                 //!< b
+
+    /**
+     * @brief Bucket of an item at distance d from b
+     */
+    auto bucket_of(UInt d) const noexcept -> size_t {
+        const auto x = uint64_t(d ^ this->last);
+        if (x == 0U) {
+            return 0U;
+        }
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long pos;
+        _BitScanReverse64(&pos, x);
+        return size_t(pos) + 1U;
+#else
+        return 64U - size_t(__builtin_clzll(x));
+#endif
+    }
+
+    /**
+     * @brief Make bucket 0 non-empty, by redistributing the lowest non-empty bucket
+     *
+     * Precondition: not empty
+     */
+    auto refill() noexcept -> void {
+        if (!this->bucket[0].is_empty()) {
+            return;
+        }
+        auto i = size_t(1);
+        while (this->bucket[i].is_empty()) {
+            ++i;
+        }
+        auto least = ~UInt(0);
+        for (const auto &it : this->bucket[i]) {
+            if (it.data.second < least) {
+                least = it.data.second;
+            }
+        }
+        this->last = least;
+        while (!this->bucket[i].is_empty()) {
+            auto &it = this->bucket[i].popleft();
+            this->bucket[this->bucket_of(it.data.second)].append(it);  // to a lower bucket
+        }
+    }
+
+    auto attach(Item &it, Int k, bool front) noexcept -> void {
+        assert(k <= this->upper);
+        it.data.second = UInt(UInt(this->upper) - UInt(k));  // modular arithmetic
+        assert(it.data.second >= this->last);  // monotone
+        auto &list = this->bucket[this->bucket_of(it.data.second)];
+        if (front) {
+            list.appendleft(it);
+        } else {
+            list.append(it);
+        }
+    }
+
+  public:
+    /**
+     * @brief Construct a new RadixHeap object
+     *
+     * @param[in] a lower bound
+     * @param[in] b upper bound
+     */
+    RadixHeap(Int a, Int b) : bucket(num_buckets), upper(b) {
+        assert(a <= b);
+        static_assert(std::is_integral<Int>::value, "bucket's key must be an integer");
+        (void)a;
+    }
+
+    RadixHeap(const RadixHeap &) = delete;                      // don't copy
+    auto operator=(const RadixHeap &) -> RadixHeap & = delete;  // don't assign
+    RadixHeap(RadixHeap &&) noexcept = default;
+    auto operator=(RadixHeap &&) noexcept -> RadixHeap & = default;
+    ~RadixHeap() = default;
+
+    /**
+     * @brief Whether the heap is empty.
+     *
+     * @return true
+     * @return false
+     */
+    auto is_empty() const noexcept -> bool { return this->num == 0U; }
+
+    /**
+     * @brief Number of items
+     *
+     * @return size_t
+     */
+    auto size() const noexcept -> size_t { return this->num; }
+
+    /**
+     * @brief Get the key of an item
+     *
+     * @param[in] it the item
+     * @return Int
+     */
+    auto get_key(const Item &it) const noexcept -> Int {
+        return Int(UInt(this->upper) - it.data.second);
+    }
+
+    /**
+     * @brief Get the max value (redistributes a bucket if needed)
+     *
+     * Precondition: not empty
+     *
+     * @return Int maximum value
+     */
+    auto get_max() noexcept -> Int {
+        assert(!this->is_empty());
+        this->refill();
+        return Int(UInt(this->upper) - this->last);
+    }
+
+    /**
+     * @brief Clear reset the heap (the next key may be up to b again)
+     */
+    auto clear() noexcept -> void {
+        for (auto &list : this->bucket) {
+            list.clear();
+        }
+        this->last = 0U;
+        this->num = 0U;
+    }
+
+    /**
+     * @brief Append item with external key to the front (of the items with the same bucket)
+     *
+     * @param[in,out] it the item
+     * @param[in] k the key, not greater than the last popped one
+     */
+    auto appendleft(Item &it, Int k) noexcept -> void {
+        this->attach(it, k, true);
+        ++this->num;
+    }
+
+    /**
+     * @brief Append item with external key
+     *
+     * @param[in,out] it the item
+     * @param[in] k the key, not greater than the last popped one
+     */
+    auto append(Item &it, Int k) noexcept -> void {
+        this->attach(it, k, false);
+        ++this->num;
+    }
+
+    /**
+     * @brief Pop node with the highest key
+     *
+     * Precondition: not empty
+     *
+     * @return Dllink&
+     */
+    auto popleft() noexcept -> Item & {
+        assert(!this->is_empty());
+        this->refill();
+        --this->num;
+        return this->bucket[0].popleft();
+    }
+
+    /**
+     * @brief Modify key by delta
+     *
+     * @param[in,out] it the item
+     * @param[in] delta the change of the key, which must stay not greater than the last
+     * popped key
+     */
+    auto modify_key(Item &it, Int delta) noexcept -> void {
+        if (it.is_locked() || delta == 0) {
+            return;
+        }
+        const auto k = this->get_key(it);
+        this->bucket[this->bucket_of(it.data.second)].detach(it);
+        if (delta > 0) {
+            this->attach(it, Int(k + delta), true);  // LIFO
+        } else {
+            this->attach(it, Int(k + delta), false);  // FIFO
+        }
+    }
+
+    /**
+     * @brief Detach the item from the heap
+     *
+     * @param[in,out] it the item
+     */
+    auto detach(Item &it) noexcept -> void {
+        this->bucket[this->bucket_of(it.data.second)].detach(it);
+        --this->num;
+    }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <vector>
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
 
 namespace fun {
 
@@ -91,8 +92,246 @@ namespace fun {
              */
             auto end() const -> RobinIterator<T> { return RobinIterator<T>{node}; }
         };
+
+        /**
+         * The code snippet defines a struct template called `RobinRotatingIterator`. Like
+         * `RobinIterator`, it follows the `next` pointers of the cycle, but it skips the excluded
+         * node and stops after a given number of steps, so that it may start anywhere.
+         *
+         * @tparam T
+         */
+        template <typename T> struct RobinRotatingIterator {
+            const RobinSlNode<T> *cur;
+            const RobinSlNode<T> *skip;
+            size_t remaining;
+
+            /**
+             * The function checks if the current iterator is not equal to another iterator.
+             *
+             * @param[in] other The iterator being compared to the current object.
+             *
+             * @return true if the two iterators have a different number of steps left.
+             */
+            auto operator!=(const RobinRotatingIterator &other) const -> bool {
+                return remaining != other.remaining;
+            }
+
+            /**
+             * The function checks if the current iterator is equal to another iterator.
+             *
+             * @param[in] other The iterator being compared to the current object.
+             *
+             * @return true if the two iterators have the same number of steps left.
+             */
+            auto operator==(const RobinRotatingIterator &other) const -> bool {
+                return remaining == other.remaining;
+            }
+
+            /**
+             * The function moves the iterator to the next node, passing over the excluded one.
+             *
+             * @return a reference to the updated iterator.
+             */
+            auto operator++() -> RobinRotatingIterator & {
+                cur = cur->next;
+                if (cur == skip) {
+                    cur = cur->next;
+                }
+                --remaining;
+                return *this;
+            }
+
+            /**
+             * The function returns a const reference to the key of the current node.
+             *
+             * @return a reference to a constant object of type T.
+             */
+            auto operator*() const -> const T & { return cur->key; }
+        };
+
+        /**
+         * The code snippet defines a struct template called `RobinRotatingIterableWrapper`. It
+         * offers the same begin()/end() interface as `RobinIterableWrapper`.
+         *
+         * @tparam T
+         */
+        template <typename T> struct RobinRotatingIterableWrapper {
+            const RobinSlNode<T> *start;
+            const RobinSlNode<T> *skip;
+            size_t count;
+
+            /**
+             * The begin() function returns an iterator pointing to the starting node.
+             *
+             * @return a `RobinRotatingIterator<T>` object.
+             */
+            auto begin() const -> RobinRotatingIterator<T> {
+                return RobinRotatingIterator<T>{start, skip, count};
+            }
+
+            /**
+             * The function returns the iterator representing the end of the traversal.
+             *
+             * @return a `RobinRotatingIterator<T>` object.
+             */
+            auto end() const -> RobinRotatingIterator<T> {
+                return RobinRotatingIterator<T>{start, skip, 0};
+            }
+        };
+
+        /**
+         * The code snippet defines a struct template called `RobinIndexIterator`. It walks the
+         * parts of a `FlatRobin` by index arithmetic instead of following `next` pointers.
+         *
+         * @tparam T
+         */
+        template <typename T> struct RobinIndexIterator {
+            T cur;
+            T num_parts;
+
+            /**
+             * The function checks if the current iterator is not equal to another iterator.
+             *
+             * @param[in] other The iterator being compared to the current object.
+             *
+             * @return true if the two iterators point to different parts.
+             */
+            constexpr auto operator!=(const RobinIndexIterator &other) const -> bool {
+                return cur != other.cur;
+            }
+
+            /**
+             * The function checks if the current iterator is equal to another iterator.
+             *
+             * @param[in] other The iterator being compared to the current object.
+             *
+             * @return true if the two iterators point to the same part.
+             */
+            constexpr auto operator==(const RobinIndexIterator &other) const -> bool {
+                return cur == other.cur;
+            }
+
+            /**
+             * The function moves the iterator to the next part, wrapping around after the last
+             * one.
+             *
+             * @return a reference to the updated iterator.
+             */
+            constexpr auto operator++() -> RobinIndexIterator & {
+                ++cur;
+                if (cur == num_parts) {
+                    cur = T(0);
+                }
+                return *this;
+            }
+
+            /**
+             * The function returns the current part.
+             *
+             * @return a const reference to the current part.
+             */
+            constexpr auto operator*() const -> const T & { return cur; }
+        };
+
+        /**
+         * The code snippet defines a struct template called `RobinIndexRange`. It is a contiguous
+         * range of parts [first, last) that is traversed by plain increments.
+         *
+         * @tparam T
+         */
+        template <typename T> struct RobinIndexRange {
+            T first;
+            T last;
+
+            /**
+             * The begin() function returns an iterator pointing to the first part.
+             *
+             * @return a `RobinIndexIterator<T>` object that never wraps around.
+             */
+            constexpr auto begin() const -> RobinIndexIterator<T> {
+                return RobinIndexIterator<T>{first, T(0)};
+            }
+
+            /**
+             * The function returns an iterator pointing past the last part.
+             *
+             * @return a `RobinIndexIterator<T>` object.
+             */
+            constexpr auto end() const -> RobinIndexIterator<T> {
+                return RobinIndexIterator<T>{last, T(0)};
+            }
+        };
+
+        /**
+         * The code snippet defines a struct template called `FlatRobinIterableWrapper`. It is the
+         * counterpart of `RobinIterableWrapper` for `FlatRobin`, and can also be split into two
+         * contiguous ranges.
+         *
+         * @tparam T
+         */
+        template <typename T> struct FlatRobinIterableWrapper {
+            T from_part;
+            T num_parts;
+
+            /**
+             * The begin() function returns an iterator pointing to the part after `from_part`.
+             *
+             * @return a `RobinIndexIterator<T>` object.
+             */
+            constexpr auto begin() const -> RobinIndexIterator<T> {
+                auto it = RobinIndexIterator<T>{from_part, num_parts};
+                return ++it;
+            }
+
+            /**
+             * The function returns the iterator representing the end of the traversal, i.e.
+             * `from_part` itself.
+             *
+             * @return a `RobinIndexIterator<T>` object.
+             */
+            constexpr auto end() const -> RobinIndexIterator<T> {
+                return RobinIndexIterator<T>{from_part, num_parts};
+            }
+
+            /**
+             * The function returns the first contiguous range, i.e. `from_part + 1 .. k - 1`.
+             *
+             * @return a `RobinIndexRange<T>` object.
+             */
+            constexpr auto first() const -> RobinIndexRange<T> {
+                return RobinIndexRange<T>{T(from_part + 1), num_parts};
+            }
+
+            /**
+             * The function returns the second contiguous range, i.e. `0 .. from_part - 1`.
+             *
+             * @return a `RobinIndexRange<T>` object.
+             */
+            constexpr auto second() const -> RobinIndexRange<T> {
+                return RobinIndexRange<T>{T(0), from_part};
+            }
+        };
     }  // namespace detail
 
+    /**
+     * @brief Per-caller cursor of a rotating Round Robin
+     *
+     * The `RobinCursor` struct holds the rotation of a caller (e.g. a thread). Callers that start
+     * from different rounds, e.g. `RobinCursor<T>{T(thread_id)}`, probe the target parts in
+     * different orders, and calling `next_round()` after each use spreads the starting points of a
+     * single caller evenly over the parts. It may live in a `thread_local` variable.
+     *
+     * @tparam T
+     */
+    template <typename T> struct RobinCursor {
+        T round{};
+
+        /**
+         * The `next_round` method moves the starting point one part further.
+         */
+        constexpr auto next_round() noexcept -> void { ++this->round; }
+    };
+
     /**
      * @brief Round Robin
      *
@@ -139,6 +378,80 @@ namespace fun {
         auto exclude(T from_part) const -> detail::RobinIterableWrapper<T> {
             return detail::RobinIterableWrapper<T>{&this->cycle[from_part]};
         }
+
+        /**
+         * The `exclude` method with a cursor visits the same parts as `exclude(from_part)`, but
+         * the traversal is rotated by the round of the cursor: with round r, it starts at the
+         * (r mod (k - 1))-th part after `from_part` and wraps around. The cursor is not advanced;
+         * call `cursor.next_round()` for that.
+         *
+         * @param[in] from_part The part of the cycle that you want to exclude.
+         * @param[in] cursor The rotating cursor of the caller.
+         *
+         * @return an iterable wrapper of type `detail::RobinRotatingIterableWrapper<T>`.
+         */
+        auto exclude(T from_part, const RobinCursor<T> &cursor) const
+            -> detail::RobinRotatingIterableWrapper<T> {
+            const auto num_parts = this->cycle.size();
+            const auto *skip = &this->cycle[from_part];
+            if (num_parts < 2) {
+                return detail::RobinRotatingIterableWrapper<T>{skip, skip, 0};
+            }
+            const auto shift = size_t(cursor.round) % (num_parts - 1);
+            const auto start = (size_t(from_part) + 1 + shift) % num_parts;
+            return detail::RobinRotatingIterableWrapper<T>{&this->cycle[start], skip,
+                                                           num_parts - 1};
+        }
+    };
+
+    /**
+     * @brief Round Robin without pointers
+     *
+     * The `FlatRobin` class visits the parts in the same order as `Robin`, but it holds no
+     * linked cycle: the parts are computed by index arithmetic, so that there is no dependent
+     * load per step. Moreover, `exclude(from_part)` can be split into the two contiguous ranges
+     * `from_part + 1 .. k - 1` and `0 .. from_part - 1`, and `for_each_excluding` runs a callable
+     * over them as two plain counted loops, which the compiler can unroll or vectorize.
+     *
+     * @tparam T
+     */
+    template <typename T> struct FlatRobin {
+        T num_parts;
+
+        /**
+         * The FlatRobin constructor records the number of parts.
+         *
+         * @param[in] num_parts The number of parts in the cycle.
+         */
+        constexpr explicit FlatRobin(T num_parts) : num_parts{num_parts} {}
+
+        /**
+         * The `exclude` method returns an iterable wrapper that visits all the parts except
+         * `from_part`, starting right after it.
+         *
+         * @param[in] from_part The part of the cycle that you want to exclude.
+         *
+         * @return an iterable wrapper of type `detail::FlatRobinIterableWrapper<T>`.
+         */
+        constexpr auto exclude(T from_part) const -> detail::FlatRobinIterableWrapper<T> {
+            return detail::FlatRobinIterableWrapper<T>{from_part, this->num_parts};
+        }
+
+        /**
+         * The `for_each_excluding` method calls `f(to_part)` for all the parts except
+         * `from_part`, in the same order as `exclude(from_part)`.
+         *
+         * @param[in] from_part The part of the cycle that you want to exclude.
+         * @param[in] f The callable, taking a part.
+         */
+        template <typename F> constexpr auto for_each_excluding(T from_part, F &&f) const -> void {
+            for (auto to_part = T(from_part + 1); to_part < this->num_parts; ++to_part) {
+                f(to_part);
+            }
+            for (auto to_part = T(0); to_part < from_part; ++to_part) {
+                f(to_part);
+            }
+        }
     };
 
 }  // namespace fun
@@ -0,0 +1,376 @@
+#pragma once
+
+#include <algorithm>    // for max, min
+#include <atomic>       // for atomic, memory_order
+#include <cassert>      // for assert
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t
+#include <iterator>     // for size
+#include <memory>       // for unique_ptr, make_unique
+#include <mutex>        // for mutex, lock_guard
+#include <thread>       // for thread
+#include <type_traits>  // for make_unsigned_t, is_convertible
+#include <utility>      // for pair, declval
+#include <vector>       // for vector
+
+#include "bpqueue.hpp"  // for BPQueue
+
+/**
+ * @brief Vertex id of an item: its `data.first` (default VertexId of ShardedBPQueue)
+ */
+struct ItemVertexId {
+    template <typename Item>
+    constexpr auto operator()(const Item &it) const noexcept -> decltype(it.data.first) {
+        return it.data.first;
+    }
+};
+
+/**
+ * @brief Bounded priority queue split into independently locked shards
+ *
+ * The vertex set is split across shards (e.g. one per thread). Each shard
+ * is a BPQueue guarded by its own mutex, and publishes its current max key
+ * through an atomic, so that reading the global max estimate is lock-free
+ * and only the shard being popped or updated gets locked. The caller is
+ * responsible for sending the updates of an item to the shard that holds
+ * it (typically `vertex % num_shards()`).
+ *
+ * The global max is an estimate: under concurrent updates, try_pop_max()
+ * returns the head of the shard that looked best at the time it was
+ * scanned. When the queue is quiescent it returns a true max item.
+ *
+ * For runs that must be reproducible across thread counts, the
+ * deterministic mode orders the ties by vertex id instead of by the
+ * FIFO/LIFO order within a shard: build(), append_ordered() and
+ * modify_key_ordered() keep the items of every bucket of a shard sorted
+ * by id, so that try_pop_max_ordered() only has to merge the heads of the
+ * shards, as in a k-way merge. The popped sequence then only depends on
+ * the keys and ids, not on the number of shards or threads.
+ *
+ * @tparam Tp
+ * @tparam Int
+ * @tparam Sequence
+ * @tparam BucketIndex
+ * @tparam VertexId callable giving the vertex id of an item, totally ordered by `<`
+ */
+template <typename Tp, typename Int = int32_t,
+          typename Sequence = std::vector<Dllist<std::pair<Tp, std::make_unsigned_t<Int>>>>,
+          typename BucketIndex = LinearBucketScan, typename VertexId = ItemVertexId>
+class ShardedBPQueue {
+    using Item = typename Sequence::value_type::node_type;
+    using Queue = BPQueue<Tp, Int, Sequence, BucketIndex>;
+    using Id = decltype(std::declval<const VertexId &>()(std::declval<const Item &>()));
+
+    static_assert(std::is_convertible<decltype(std::declval<Id>() < std::declval<Id>()),
+                                      bool>::value,
+                  "vertex ids must be ordered by <");
+
+    /**
+     * @brief A shard, on its own cache line to avoid false sharing
+     */
+    struct alignas(64) Shard {
+        std::mutex mutex;              //!< guards bpq
+        Queue bpq;                     //!< the shard's queue
+        std::atomic<Int> published{};  //!< bpq.get_max() as last seen by a writer
+
+        Shard(Int a, Int b) : bpq{a, b}, published{bpq.get_max()} {}
+
+        auto publish() noexcept -> void {
+            this->published.store(this->bpq.get_max(), std::memory_order_release);
+        }
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    Int offset;             //!< a - 1, i.e. the max of an empty shard
+    VertexId vertex_id{};  //!< vertex id of an item
+
+    /**
+     * @brief Order of the items by vertex id
+     */
+    auto id_less() const noexcept {
+        return [this](const Item &lhs, const Item &rhs) {
+            return this->vertex_id(lhs) < this->vertex_id(rhs);
+        };
+    }
+
+  public:
+    /**
+     * @brief Construct a new ShardedBPQueue object
+     *
+     * @param[in] a lower bound
+     * @param[in] b upper bound
+     * @param[in] num_shards number of shards
+     */
+    ShardedBPQueue(Int a, Int b, size_t num_shards) : offset(a - 1) {
+        assert(num_shards > 0);
+        this->shards.reserve(num_shards);
+        for (auto s = size_t(0); s != num_shards; ++s) {
+            this->shards.emplace_back(std::make_unique<Shard>(a, b));
+        }
+    }
+
+    /**
+     * @brief Number of shards
+     *
+     * @return size_t
+     */
+    auto num_shards() const noexcept -> size_t { return this->shards.size(); }
+
+    /**
+     * @brief Estimate of the global max value (lock-free)
+     *
+     * @return Int maximum value, or a - 1 if all shards are empty
+     */
+    auto get_max() const noexcept -> Int {
+        auto res = this->offset;
+        for (const auto &shard : this->shards) {
+            const auto key = shard->published.load(std::memory_order_acquire);
+            if (res < key) {
+                res = key;
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @brief Whether all shards look empty (lock-free)
+     *
+     * @return true
+     * @return false
+     */
+    auto is_empty() const noexcept -> bool { return this->get_max() == this->offset; }
+
+    /**
+     * @brief Append a range of items with their external keys, in parallel
+     *
+     * Item v goes to shard v % num_shards(), and each shard receives its
+     * items in the order of the range, so that the content of every shard
+     * does not depend on the number of threads. The ties are kept in id
+     * order (as by append_ordered()), at no extra cost when the range is
+     * in id order.
+     *
+     * @param[in,out] items random-access range of items
+     * @param[in] gains random-access range of the keys (same length)
+     * @param[in] num_threads number of threads (0 for std::thread::hardware_concurrency)
+     */
+    template <typename ItemRange, typename GainRange>
+    auto build(ItemRange &items, const GainRange &gains, size_t num_threads = 0) -> void {
+        if (num_threads == 0) {
+            num_threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+        num_threads = std::min(num_threads, this->shards.size());
+        const auto n = size_t(std::size(items));
+        const auto step = this->shards.size();
+        auto run = [&, n, step, num_threads](size_t first) {
+            for (auto s = first; s < step; s += num_threads) {
+                auto &shard = *this->shards[s];
+                const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+                for (auto v = s; v < n; v += step) {
+                    shard.bpq.append_sorted(items[v], Int(gains[v]), this->id_less());
+                }
+                shard.publish();
+            }
+        };
+        auto workers = std::vector<std::thread>{};
+        workers.reserve(num_threads - 1);
+        for (auto t = size_t(1); t < num_threads; ++t) {
+            workers.emplace_back(run, t);
+        }
+        run(0);
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Append item with external key to shard s
+     *
+     * @param[in] s the shard
+     * @param[in,out] it the item
+     * @param[in] k the key
+     */
+    auto append(size_t s, Item &it, Int k) -> void {
+        auto &shard = *this->shards[s];
+        const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+        shard.bpq.append(it, k);
+        shard.publish();
+    }
+
+    /**
+     * @brief Append item with external key to the front of shard s
+     *
+     * @param[in] s the shard
+     * @param[in,out] it the item
+     * @param[in] k the key
+     */
+    auto appendleft(size_t s, Item &it, Int k) -> void {
+        auto &shard = *this->shards[s];
+        const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+        shard.bpq.appendleft(it, k);
+        shard.publish();
+    }
+
+    /**
+     * @brief Modify key by delta of an item of shard s
+     *
+     * @param[in] s the shard
+     * @param[in,out] it the item
+     * @param[in] delta the change of the key
+     */
+    auto modify_key(size_t s, Item &it, Int delta) -> void {
+        auto &shard = *this->shards[s];
+        const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+        shard.bpq.modify_key(it, delta);
+        shard.publish();
+    }
+
+    /**
+     * @brief Append item with external key to shard s, after the ties with lower ids
+     *
+     * The cost is the number of ties with higher ids (see BPQueue::append_sorted()).
+     *
+     * @param[in] s the shard
+     * @param[in,out] it the item
+     * @param[in] k the key
+     */
+    auto append_ordered(size_t s, Item &it, Int k) -> void {
+        auto &shard = *this->shards[s];
+        const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+        shard.bpq.append_sorted(it, k, this->id_less());
+        shard.publish();
+    }
+
+    /**
+     * @brief Modify key by delta of an item of shard s, keeping the ties in id order
+     *
+     * @param[in] s the shard
+     * @param[in,out] it the item
+     * @param[in] delta the change of the key
+     */
+    auto modify_key_ordered(size_t s, Item &it, Int delta) -> void {
+        auto &shard = *this->shards[s];
+        const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+        shard.bpq.modify_key_sorted(it, delta, this->id_less());
+        shard.publish();
+    }
+
+    /**
+     * @brief Modify keys of a batch of items of shard s
+     *
+     * @param[in] s the shard
+     * @param[in] items range of pointers to the items
+     * @param[in] deltas range of the changes of the keys
+     */
+    template <typename ItemRange, typename DeltaRange>
+    auto modify_keys(size_t s, const ItemRange &items, const DeltaRange &deltas) -> void {
+        auto &shard = *this->shards[s];
+        const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+        shard.bpq.modify_keys(items, deltas);
+        shard.publish();
+    }
+
+    /**
+     * @brief Detach an item from shard s
+     *
+     * @param[in] s the shard
+     * @param[in,out] it the item
+     */
+    auto detach(size_t s, Item &it) -> void {
+        auto &shard = *this->shards[s];
+        const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+        shard.bpq.detach(it);
+        shard.publish();
+    }
+
+    /**
+     * @brief Pop an item from the shard with the highest published max
+     *
+     * Only the chosen shard is locked. If it turns out to have been
+     * emptied meanwhile, the shards are scanned again.
+     *
+     * @return std::pair<Item *, size_t> the item (nullptr if all shards
+     * are empty) and the shard it was popped from
+     */
+    auto try_pop_max() -> std::pair<Item *, size_t> {
+        for (;;) {
+            auto best = this->shards.size();
+            auto best_key = this->offset;
+            for (auto s = size_t(0); s != this->shards.size(); ++s) {
+                const auto key = this->shards[s]->published.load(std::memory_order_acquire);
+                if (best_key < key) {
+                    best_key = key;
+                    best = s;
+                }
+            }
+            if (best == this->shards.size()) {
+                return {nullptr, best};
+            }
+            auto &shard = *this->shards[best];
+            const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+            if (shard.bpq.is_empty()) {
+                shard.publish();
+                continue;
+            }
+            auto &res = shard.bpq.popleft();
+            shard.publish();
+            return {&res, best};
+        }
+    }
+
+    /**
+     * @brief Pop the item with the highest key, and the lowest vertex id among them
+     *
+     * Deterministic mode: compares the heads of the shards with the
+     * highest published key, which are their lowest ids provided that the
+     * shards were only filled and updated by build(), append_ordered()
+     * and modify_key_ordered(). Only one shard is locked at a time, so the
+     * cost is O(num_shards()) per pop. When the queue is quiescent, the
+     * sequence popped only depends on the keys and ids.
+     *
+     * @return std::pair<Item *, size_t> the item (nullptr if all shards
+     * are empty) and the shard it was popped from
+     */
+    auto try_pop_max_ordered() -> std::pair<Item *, size_t> {
+        for (;;) {
+            auto best_key = this->offset;
+            for (const auto &shard : this->shards) {
+                const auto key = shard->published.load(std::memory_order_acquire);
+                if (best_key < key) {
+                    best_key = key;
+                }
+            }
+            if (best_key == this->offset) {
+                return {nullptr, this->shards.size()};
+            }
+            Item *res = nullptr;
+            auto best = this->shards.size();
+            for (auto s = size_t(0); s != this->shards.size(); ++s) {
+                auto &shard = *this->shards[s];
+                if (shard.published.load(std::memory_order_acquire) != best_key) {
+                    continue;
+                }
+                const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+                if (shard.bpq.get_max() != best_key) {
+                    continue;
+                }
+                auto &head = shard.bpq.front();
+                if (res == nullptr || this->vertex_id(head) < this->vertex_id(*res)) {
+                    res = &head;
+                    best = s;
+                }
+            }
+            if (res == nullptr) {
+                continue;  // changed meanwhile
+            }
+            auto &shard = *this->shards[best];
+            const auto lock = std::lock_guard<std::mutex>{shard.mutex};
+            if (shard.bpq.is_empty() || shard.bpq.get_max() != best_key
+                || &shard.bpq.front() != res) {
+                continue;  // changed meanwhile
+            }
+            shard.bpq.popleft();
+            shard.publish();
+            return {res, best};
+        }
+    }
+};
@@ -0,0 +1,411 @@
+#pragma once
+
+#include <cassert>      // for assert
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t, uint32_t
+#include <iterator>     // for begin, end
+#include <type_traits>  // for make_unsigned_t, is_integral
+#include <vector>       // for vector
+
+#include "bucket_index.hpp"  // for LinearBucketScan
+
+/**
+ * @brief Bounded priority queue in structure-of-arrays layout
+ *
+ * Same algorithm as BPQueue, but the items are identified by their
+ * (vertex) id in [0, num_items) rather than by Dllink nodes. The links,
+ * the keys and the payloads are held in three parallel arrays indexed by
+ * the id. Hence bulk key reads only touch the key array, and relinking
+ * only touches the link array. The bucket heads and the sentinel are
+ * stored at the end of the link array, so that links are 32-bit indices.
+ *
+ * As in BPQueue, items are either attached to the queue or locked, and
+ * all the member functions assume that the keys are inside the bounds.
+ *
+ * @tparam Tp payload type
+ * @tparam Int key type
+ * @tparam BucketIndex max-tracking policy
+ */
+template <typename Tp, typename Int = int32_t, typename BucketIndex = LinearBucketScan>
+class SoaBPQueue {
+    using UInt = std::make_unsigned_t<Int>;
+    static constexpr uint32_t npos = ~uint32_t(0);
+
+    struct Link {
+        uint32_t next; /**< index of the next node */
+        uint32_t prev; /**< index of the previous node */
+    };
+
+    /**
+     * @brief View of the bucket heads, as required by BucketIndex
+     */
+    struct Heads {
+        struct Head {
+            const Link *links;
+            uint32_t pos;
+            constexpr auto is_empty() const noexcept -> bool { return links[pos].next == pos; }
+        };
+
+        const Link *links;
+        uint32_t first;
+        constexpr auto operator[](size_t k) const noexcept -> Head {
+            return Head{links, static_cast<uint32_t>(first + k)};
+        }
+    };
+
+  public:
+    using value_type = Tp;
+    using size_type = size_t;
+
+  private:
+    std::vector<Link> links;   //!< [0, n) items, [n, n + high] bucket heads, then the sentinel
+    std::vector<UInt> keys;    //!< internal key of each item
+    std::vector<Tp> payloads;  //!< payload of each item
+    BucketIndex index;         //!< occupancy index of bucket
+    UInt max{};                //!< max value
+    Int offset;                //!< a - 1
+    UInt high;                 //!< b - a + 1
+    uint32_t first;            //!< position of the head of bucket 0
+
+    constexpr auto heads() const noexcept -> Heads {
+        return Heads{this->links.data(), this->first};
+    }
+
+    constexpr auto head(UInt key) const noexcept -> uint32_t {
+        return static_cast<uint32_t>(this->first + key);
+    }
+
+    /**
+     * @brief attach node i right after node at
+     */
+    constexpr auto attach(uint32_t at, uint32_t i) noexcept -> void {
+        auto &pos = this->links[at];
+        this->links[i].next = pos.next;
+        this->links[pos.next].prev = i;
+        pos.next = i;
+        this->links[i].prev = at;
+    }
+
+    /**
+     * @brief detach node i from its list
+     */
+    constexpr auto unlink(uint32_t i) noexcept -> void {
+        assert(!this->is_locked(i));
+        const auto n = this->links[i].next;
+        const auto p = this->links[i].prev;
+        this->links[p].next = n;
+        this->links[n].prev = p;
+    }
+
+  public:
+    /**
+     * @brief Construct a new SoaBPQueue object
+     *
+     * All items are initially locked.
+     *
+     * @param[in] a lower bound
+     * @param[in] b upper bound
+     * @param[in] num_items number of items
+     */
+    SoaBPQueue(Int a, Int b, size_t num_items)
+        : links(num_items + static_cast<UInt>(b - a) + 3U, Link{npos, npos}),
+          keys(num_items),
+          payloads(num_items),
+          index(static_cast<UInt>(b - a) + 2U),
+          offset(a - 1),
+          high(static_cast<UInt>(b - offset)),
+          first(static_cast<uint32_t>(num_items)) {
+        assert(a <= b);
+        assert(this->links.size() < npos);
+        static_assert(std::is_integral<Int>::value, "bucket's key must be an integer");
+        for (auto k = UInt(0); k <= this->high; ++k) {
+            this->links[this->head(k)] = Link{this->head(k), this->head(k)};
+        }
+        this->attach(this->head(0), this->head(UInt(this->high + 1U)));  // sentinel
+    }
+
+    /**
+     * @brief Whether the %SoaBPQueue is empty.
+     *
+     * @return true
+     * @return false
+     */
+    constexpr auto is_empty() const noexcept -> bool { return this->max == 0U; }
+
+    /**
+     * @brief Number of items
+     *
+     * @return size_t
+     */
+    constexpr auto size() const noexcept -> size_t { return this->keys.size(); }
+
+    /**
+     * @brief Get the payload of item v
+     *
+     * @param[in] v the item
+     * @return Tp&
+     */
+    constexpr auto payload(uint32_t v) noexcept -> Tp & { return this->payloads[v]; }
+
+    /**
+     * @brief Get the payload of item v
+     *
+     * @param[in] v the item
+     * @return const Tp&
+     */
+    constexpr auto payload(uint32_t v) const noexcept -> const Tp & { return this->payloads[v]; }
+
+    /**
+     * @brief Set the key of item v (without relinking)
+     *
+     * @param[in] v the item
+     * @param[in] gain the key of v
+     */
+    constexpr auto set_key(uint32_t v, Int gain) noexcept -> void {
+        this->keys[v] = static_cast<UInt>(gain - this->offset);
+    }
+
+    /**
+     * @brief Get the key of item v
+     *
+     * @param[in] v the item
+     * @return Int
+     */
+    constexpr auto get_key(uint32_t v) const noexcept -> Int {
+        return this->offset + Int(this->keys[v]);
+    }
+
+    /**
+     * @brief Get the max value
+     *
+     * @return Int maximum value
+     */
+    constexpr auto get_max() const noexcept -> Int { return this->offset + Int(this->max); }
+
+    /**
+     * @brief lock item v (and don't append it to the queue)
+     *
+     * @param[in] v the item
+     */
+    constexpr auto lock(uint32_t v) noexcept -> void { this->links[v].next = npos; }
+
+    /**
+     * @brief whether item v is locked
+     *
+     * @param[in] v the item
+     * @return true
+     * @return false
+     */
+    constexpr auto is_locked(uint32_t v) const noexcept -> bool {
+        return this->links[v].next == npos;
+    }
+
+    /**
+     * @brief Clear reset the PQ
+     */
+    constexpr auto clear() noexcept -> void {
+        while (this->max > 0) {
+            const auto h = this->head(this->max);
+            this->links[h] = Link{h, h};
+            this->max -= 1;
+        }
+        this->index.clear();
+    }
+
+    /**
+     * @brief Append item with internal key
+     *
+     * @param[in] v the item
+     */
+    constexpr auto appendleft_direct(uint32_t v) noexcept -> void {
+        assert(static_cast<Int>(this->keys[v]) > this->offset);
+        this->appendleft(v, Int(this->keys[v]));
+    }
+
+    /**
+     * @brief Append item with external key
+     *
+     * @param[in] v the item
+     * @param[in] k  the key
+     */
+    constexpr auto appendleft(uint32_t v, Int k) noexcept -> void {
+        assert(k > this->offset);
+        const auto key = UInt(k - this->offset);
+        this->keys[v] = key;
+        if (this->max < key) {
+            this->max = key;
+        }
+        this->attach(this->head(key), v);
+        this->index.mark(key);
+    }
+
+    /**
+     * @brief Append item with external key
+     *
+     * @param[in] v the item
+     * @param[in] k  the key
+     */
+    constexpr auto append(uint32_t v, Int k) noexcept -> void {
+        assert(k > this->offset);
+        const auto key = UInt(k - this->offset);
+        this->keys[v] = key;
+        if (this->max < key) {
+            this->max = key;
+        }
+        this->attach(this->links[this->head(key)].prev, v);
+        this->index.mark(key);
+    }
+
+    /**
+     * @brief Append items 0, 1, ..., n - 1 with their external keys in bulk
+     *
+     * See BPQueue::build().
+     *
+     * @param[in] gains range of the keys of the first n items
+     */
+    template <typename GainRange>
+    constexpr auto build(const GainRange &gains) noexcept -> void {
+        auto v = 0U;
+        for (const auto gain : gains) {
+            assert(Int(gain) > this->offset);
+            const auto key = UInt(Int(gain) - this->offset);
+            assert(key <= this->high);
+            this->keys[v] = key;
+            this->attach(this->links[this->head(key)].prev, v);
+            this->index.mark(key);
+            ++v;
+        }
+        this->max = this->index.find_max(this->heads(), this->high);
+    }
+
+    /**
+     * @brief Pop item with the highest key
+     *
+     * @return uint32_t the item
+     */
+    constexpr auto popleft() noexcept -> uint32_t {
+        const auto res = this->links[this->head(this->max)].next;
+        this->unlink(res);
+        this->index.unmark_if_empty(this->heads(), this->max);
+        this->max = this->index.find_max(this->heads(), this->max);
+        return res;
+    }
+
+    /**
+     * @brief Decrease key by delta
+     *
+     * @param[in] v the item
+     * @param[in] delta the change of the key
+     *
+     * Note that the order of items with same key will not be preserved.
+     * For the Fiduccia-Mattheyses algorithm, this is a prefered behavior.
+     */
+    constexpr auto decrease_key(uint32_t v, UInt delta) noexcept -> void {
+        this->unlink(v);
+        this->index.unmark_if_empty(this->heads(), this->keys[v]);
+        this->keys[v] -= delta;
+        const auto key = this->keys[v];
+        assert(key > 0);
+        assert(key <= this->high);
+        this->attach(this->links[this->head(key)].prev, v);  // FIFO
+        this->index.mark(key);
+        if (this->max < key) {
+            this->max = key;
+            return;
+        }
+        this->max = this->index.find_max(this->heads(), this->max);
+    }
+
+    /**
+     * @brief Increase key by delta
+     *
+     * @param[in] v the item
+     * @param[in] delta the change of the key
+     *
+     * Note that the order of items with same key will not be preserved.
+     * For the Fiduccia-Mattheyses algorithm, this is a prefered behavior.
+     */
+    constexpr auto increase_key(uint32_t v, UInt delta) noexcept -> void {
+        this->unlink(v);
+        this->index.unmark_if_empty(this->heads(), this->keys[v]);
+        this->keys[v] += delta;
+        const auto key = this->keys[v];
+        assert(key > 0);
+        assert(key <= this->high);
+        this->attach(this->head(key), v);  // LIFO
+        this->index.mark(key);
+        if (this->max < key) {
+            this->max = key;
+        }
+    }
+
+    /**
+     * @brief Modify key by delta
+     *
+     * @param[in] v the item
+     * @param[in] delta the change of the key
+     *
+     * Note that the order of items with same key will not be preserved.
+     * For Fiduccia-Mattheyses algorithm, this is a prefered behavior.
+     */
+    constexpr auto modify_key(uint32_t v, Int delta) noexcept -> void {
+        if (this->is_locked(v)) {
+            return;
+        }
+        if (delta > 0) {
+            this->increase_key(v, UInt(delta));
+        } else if (delta < 0) {
+            this->decrease_key(v, UInt(-delta));
+        }
+    }
+
+    /**
+     * @brief Modify keys of a batch of items
+     *
+     * Equivalent to calling modify_key(ids[i], deltas[i]) for each i,
+     * except that all relinks are applied first and the max is searched
+     * only once at the end. Locked items are skipped.
+     *
+     * @param[in] ids range of the items
+     * @param[in] deltas range of the changes of the keys (same length)
+     */
+    template <typename IdRange, typename DeltaRange>
+    constexpr auto modify_keys(const IdRange &ids, const DeltaRange &deltas) noexcept -> void {
+        auto delta = std::begin(deltas);
+        for (const auto v : ids) {
+            const auto d = Int(*delta);
+            ++delta;
+            if (this->is_locked(uint32_t(v)) || d == 0) {
+                continue;
+            }
+            this->unlink(uint32_t(v));
+            this->index.unmark_if_empty(this->heads(), this->keys[v]);
+            this->keys[v] = UInt(this->keys[v] + UInt(d));  // modular arithmetic
+            const auto key = this->keys[v];
+            assert(key > 0);
+            assert(key <= this->high);
+            if (d > 0) {
+                this->attach(this->head(key), uint32_t(v));  // LIFO
+            } else {
+                this->attach(this->links[this->head(key)].prev, uint32_t(v));  // FIFO
+            }
+            this->index.mark(key);
+            if (this->max < key) {
+                this->max = key;
+            }
+        }
+        assert(delta == std::end(deltas));
+        this->max = this->index.find_max(this->heads(), this->max);
+    }
+
+    /**
+     * @brief Detach the item from SoaBPQueue
+     *
+     * @param[in] v the item
+     */
+    constexpr auto detach(uint32_t v) noexcept -> void {
+        this->unlink(v);
+        this->index.unmark_if_empty(this->heads(), this->keys[v]);
+        this->max = this->index.find_max(this->heads(), this->max);
+    }
+};
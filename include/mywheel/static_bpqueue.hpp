@@ -0,0 +1,428 @@
+#pragma once
+
+#include <array>        // for array
+#include <cassert>      // for assert
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t, int64_t, uint64_t
+#include <iterator>     // for begin, end
+#include <limits>       // for numeric_limits
+#include <type_traits>  // for make_unsigned_t, is_integral
+#include <utility>      // for pair
+
+#include "dllist.hpp"  // for Dllink, DllIterator
+
+// Forward declaration for begin() end()
+template <typename Tp, int A, int B, typename Int = int32_t> class StaticBpqIterator;
+
+/**
+ * @brief Bounded priority queue with a compile-time key range
+ *
+ * Same as BPQueue (see bpqueue.hpp), but the bounds [A..B] are template
+ * parameters. The bucket array is a std::array, so that the queue needs
+ * no heap allocation, and the offset and the upper bound fold into
+ * constants. All member functions are constexpr. The items are of the
+ * same type as those of BPQueue<Tp, Int>, and the core of the interface
+ * is the same (is_empty, set_key, get_max, clear, appendleft_direct,
+ * appendleft, append, build, popleft, decrease_key, increase_key,
+ * modify_key, modify_keys, detach, top_k and the iteration), so that code
+ * templated on the queue type and restricted to it works with both. The
+ * parts of BPQueue that change the bounds (reset, shift_keys) or that
+ * depend on its policies (stats, range, the undo journal) are left out.
+ *
+ * The bounds are given as int, and must fit in Int (checked at compile
+ * time), e.g. StaticBPQueue<Tp, -100, 100, int8_t> for 8-bit keys.
+ *
+ * @tparam Tp
+ * @tparam A lower bound
+ * @tparam B upper bound
+ * @tparam Int
+ */
+template <typename Tp, int A, int B, typename Int = int32_t> class StaticBPQueue {
+    static_assert(std::is_integral<Int>::value, "bucket's key must be an integer");
+    static_assert(A <= B, "lower bound must not exceed upper bound");
+    static_assert(std::numeric_limits<Int>::min() < A && B <= std::numeric_limits<Int>::max(),
+                  "bounds (and a - 1) must fit in the key type");
+    static_assert(uint64_t(int64_t(B) - int64_t(A)) + 1U
+                      <= uint64_t(std::numeric_limits<std::make_unsigned_t<Int>>::max()),
+                  "b - a + 1 must fit in the unsigned key type");
+
+    using UInt = std::make_unsigned_t<Int>;
+
+    friend StaticBpqIterator<Tp, A, B, Int>;
+    using Item = Dllink<std::pair<Tp, UInt>>;
+
+    static constexpr Int offset = Int(A) - 1;          //!< a - 1
+    static constexpr UInt high = UInt(Int(B) - offset);  //!< b - a + 1
+
+  public:
+    using value_type = Dllist<std::pair<Tp, UInt>>;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using size_type = size_t;
+    using container_type = std::array<value_type, size_t(high) + 1U>;
+
+  private:
+    Item sentinel{};        //!< sentinel */
+    container_type bucket;  //!< bucket, array of lists
+    UInt max{};             //!< max value
+
+  public:
+    /**
+     * @brief Construct a new StaticBPQueue object
+     */
+    constexpr StaticBPQueue() noexcept { bucket[0].appendleft(this->sentinel); }
+
+    StaticBPQueue(const StaticBPQueue &) = delete;                                // don't copy
+    ~StaticBPQueue() = default;
+    constexpr auto operator=(const StaticBPQueue &) -> StaticBPQueue & = delete;  // don't assign
+    StaticBPQueue(StaticBPQueue &&) = delete;  // the buckets refer to the sentinel
+    constexpr auto operator=(StaticBPQueue &&) -> StaticBPQueue & = delete;
+
+    /**
+     * @brief Whether the %StaticBPQueue is empty.
+     *
+     * @return true
+     * @return false
+     */
+    constexpr auto is_empty() const noexcept -> bool { return this->max == 0U; }
+
+    /**
+     * @brief Set the key object
+     *
+     * @param[out] it the item
+     * @param[in] gain the key of it
+     */
+    constexpr auto set_key(Item &it, Int gain) const noexcept -> void {
+        it.data.second = static_cast<UInt>(gain - offset);
+    }
+
+    /**
+     * @brief Get the max value
+     *
+     * @return Int maximum value
+     */
+    constexpr auto get_max() const noexcept -> Int { return offset + Int(this->max); }
+
+    /**
+     * @brief Clear reset the PQ
+     */
+    constexpr auto clear() noexcept -> void {
+        while (this->max > 0) {
+            this->bucket[this->max].clear();
+            this->max -= 1;
+        }
+    }
+
+    /**
+     * @brief Append item with internal key
+     *
+     * @param[in,out] it the item
+     */
+    constexpr auto appendleft_direct(Item &it) noexcept -> void {
+        assert(static_cast<Int>(it.data.second) > offset);
+        this->appendleft(it, Int(it.data.second));
+    }
+
+    /**
+     * @brief Append item with external key
+     *
+     * @param[in,out] it the item
+     * @param[in] k  the key
+     */
+    constexpr auto appendleft(Item &it, Int k) noexcept -> void {
+        assert(k > offset);
+        it.data.second = UInt(k - offset);
+        if (this->max < it.data.second) {
+            this->max = it.data.second;
+        }
+        this->bucket[it.data.second].appendleft(it);
+    }
+
+    /**
+     * @brief Append item with external key
+     *
+     * @param[in,out] it the item
+     * @param[in] k  the key
+     */
+    constexpr auto append(Item &it, Int k) noexcept -> void {
+        assert(k > offset);
+        it.data.second = UInt(k - offset);
+        if (this->max < it.data.second) {
+            this->max = it.data.second;
+        }
+        this->bucket[it.data.second].append(it);
+    }
+
+    /**
+     * @brief Append a range of items with their external keys in bulk
+     *
+     * See BPQueue::build().
+     *
+     * @param[in,out] items range of items
+     * @param[in] gains range of the keys (same length)
+     */
+    template <typename ItemRange, typename GainRange>
+    constexpr auto build(ItemRange &items, const GainRange &gains) noexcept -> void {
+        auto gain = std::begin(gains);
+        for (auto &it : items) {
+            assert(Int(*gain) > offset);
+            it.data.second = UInt(Int(*gain) - offset);
+            ++gain;
+            assert(it.data.second <= high);
+            this->bucket[it.data.second].append(it);
+            if (this->max < it.data.second) {
+                this->max = it.data.second;
+            }
+        }
+        assert(gain == std::end(gains));
+    }
+
+    /**
+     * @brief Pop node with the highest key
+     *
+     * @return Dllink&
+     */
+    constexpr auto popleft() noexcept -> Item & {
+        auto &res = this->bucket[this->max].popleft();
+        while (this->bucket[this->max].is_empty()) {
+            this->max -= 1;
+        }
+        return res;
+    }
+
+    /**
+     * @brief Decrease key by delta
+     *
+     * @param[in,out] it the item
+     * @param[in] delta the change of the key
+     *
+     * Note that the order of items with same key will not be preserved.
+     * For the Fiduccia-Mattheyses algorithm, this is a prefered behavior.
+     */
+    constexpr auto decrease_key(Item &it, UInt delta) noexcept -> void {
+        it.detach();
+        it.data.second -= delta;
+        assert(it.data.second > 0);
+        assert(it.data.second <= high);
+        this->bucket[it.data.second].append(it);  // FIFO
+        if (this->max < it.data.second) {
+            this->max = it.data.second;
+            return;
+        }
+        while (this->bucket[this->max].is_empty()) {
+            this->max -= 1;
+        }
+    }
+
+    /**
+     * @brief Increase key by delta
+     *
+     * @param[in,out] it the item
+     * @param[in] delta the change of the key
+     *
+     * Note that the order of items with same key will not be preserved.
+     * For the Fiduccia-Mattheyses algorithm, this is a prefered behavior.
+     */
+    constexpr auto increase_key(Item &it, UInt delta) noexcept -> void {
+        it.detach();
+        it.data.second += delta;
+        assert(it.data.second > 0);
+        assert(it.data.second <= high);
+        this->bucket[it.data.second].appendleft(it);  // LIFO
+        if (this->max < it.data.second) {
+            this->max = it.data.second;
+        }
+    }
+
+    /**
+     * @brief Modify key by delta
+     *
+     * @param[in,out] it the item
+     * @param[in] delta the change of the key
+     *
+     * Note that the order of items with same key will not be preserved.
+     * For Fiduccia-Mattheyses algorithm, this is a prefered behavior.
+     */
+    constexpr auto modify_key(Item &it, Int delta) noexcept -> void {
+        if (it.is_locked()) {
+            return;
+        }
+        if (delta > 0) {
+            this->increase_key(it, UInt(delta));
+        } else if (delta < 0) {
+            this->decrease_key(it, UInt(-delta));
+        }
+    }
+
+    /**
+     * @brief Modify keys of a batch of items
+     *
+     * See BPQueue::modify_keys().
+     *
+     * @param[in] items range of pointers to the items
+     * @param[in] deltas range of the changes of the keys (same length)
+     */
+    template <typename ItemRange, typename DeltaRange>
+    constexpr auto modify_keys(const ItemRange &items, const DeltaRange &deltas) noexcept
+        -> void {
+        auto delta = std::begin(deltas);
+        for (auto *it : items) {
+            const auto d = Int(*delta);
+            ++delta;
+            if (it->is_locked() || d == 0) {
+                continue;
+            }
+            it->detach();
+            it->data.second = UInt(it->data.second + UInt(d));  // modular arithmetic
+            assert(it->data.second > 0);
+            assert(it->data.second <= high);
+            if (d > 0) {
+                this->bucket[it->data.second].appendleft(*it);  // LIFO
+            } else {
+                this->bucket[it->data.second].append(*it);  // FIFO
+            }
+            if (this->max < it->data.second) {
+                this->max = it->data.second;
+            }
+        }
+        assert(delta == std::end(deltas));
+        while (this->bucket[this->max].is_empty()) {
+            this->max -= 1;
+        }
+    }
+
+    /**
+     * @brief Detach the item from StaticBPQueue
+     *
+     * @param[in,out] it the item
+     */
+    constexpr auto detach(Item &it) noexcept -> void {
+        it.detach();
+        while (this->bucket[this->max].is_empty()) {
+            this->max -= 1;
+        }
+    }
+
+    /**
+     * @brief Write pointers to the (at most) k items with the highest keys
+     *
+     * See BPQueue::top_k().
+     *
+     * @param[in] k the number of items
+     * @param[out] out output iterator of pointers to the items
+     * @return OutputIt the end of the output
+     */
+    template <typename OutputIt> constexpr auto top_k(size_t k, OutputIt out) -> OutputIt {
+        for (auto key = this->max; key != 0U && k != 0U; --key) {
+            for (auto &it : this->bucket[key]) {
+                if (k == 0U) {
+                    break;
+                }
+                *out = &it;
+                ++out;
+                --k;
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Iterator point to the begin
+     *
+     * @return StaticBpqIterator
+     */
+    constexpr auto begin() noexcept -> StaticBpqIterator<Tp, A, B, Int> {
+        return {*this, this->max};
+    }
+
+    /**
+     * @brief Iterator point to the end
+     *
+     * @return StaticBpqIterator
+     */
+    constexpr auto end() noexcept -> StaticBpqIterator<Tp, A, B, Int> { return {*this, 0}; }
+};
+
+/**
+ * @brief Static Bounded Priority Queue Iterator
+ *
+ * Traverse the queue in descending order (see BpqIterator).
+ */
+template <typename Tp, int A, int B, typename Int> class StaticBpqIterator {
+    using UInt = std::make_unsigned_t<Int>;
+    using Item = Dllink<std::pair<Tp, UInt>>;
+    using Queue = StaticBPQueue<Tp, A, B, Int>;
+
+  private:
+    Queue &bpq;                                //!< the priority queue
+    UInt curkey;                               //!< the current key value
+    DllIterator<std::pair<Tp, UInt>> curitem;  //!< list iterator pointed to the current item.
+
+    /**
+     * @brief Get the reference of the current list
+     *
+     * @return Dllist&
+     */
+    constexpr auto curlist() noexcept -> typename Queue::reference {
+        return this->bpq.bucket[this->curkey];
+    }
+
+  public:
+    /**
+     * @brief Construct a new static bpq iterator object
+     *
+     * @param[in] bpq
+     * @param[in] curkey
+     */
+    constexpr StaticBpqIterator(Queue &bpq, UInt curkey) noexcept
+        : bpq{bpq}, curkey{curkey}, curitem{bpq.bucket[curkey].begin()} {}
+
+    /**
+     * @brief Move to the next item
+     *
+     * @return StaticBpqIterator&
+     */
+    constexpr auto operator++() noexcept -> StaticBpqIterator & {
+        ++this->curitem;
+        while (this->curitem == this->curlist().end()) {
+            do {
+                this->curkey -= 1;
+            } while (this->curlist().is_empty());
+            this->curitem = this->curlist().begin();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Get the reference of the current item
+     *
+     * @return Item&
+     */
+    constexpr auto operator*() noexcept -> Item & { return *this->curitem; }
+
+    /**
+     * @brief eq operator
+     *
+     * @param[in] lhs
+     * @param[in] rhs
+     * @return true
+     * @return false
+     */
+    friend constexpr auto operator==(const StaticBpqIterator &lhs,
+                                     const StaticBpqIterator &rhs) noexcept -> bool {
+        return lhs.curitem == rhs.curitem;
+    }
+
+    /**
+     * @brief neq operator
+     *
+     * @param[in] lhs
+     * @param[in] rhs
+     * @return true
+     * @return false
+     */
+    friend constexpr auto operator!=(const StaticBpqIterator &lhs,
+                                     const StaticBpqIterator &rhs) noexcept -> bool {
+        return !(lhs == rhs);
+    }
+};
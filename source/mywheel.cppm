@@ -0,0 +1,111 @@
+// C++20 module interface unit of mywheel (see the MYWHEEL_BUILD_MODULE option)
+//
+//     import mywheel;
+//
+// The headers are compiled once, in the global module fragment, and their entities are exported
+// by using-declarations, so that the importers don't parse them again.
+module;
+
+#include <mywheel/aligned_dllist.hpp>
+#include <mywheel/array_like.hpp>
+#include <mywheel/bpq_journal.hpp>
+#include <mywheel/bpq_stats.hpp>
+#include <mywheel/bpqueue.hpp>
+#include <mywheel/bucket_index.hpp>
+#include <mywheel/concurrent_dllist.hpp>
+#include <mywheel/dllink.hpp>
+#include <mywheel/dllink_pool.hpp>
+#include <mywheel/dllist.hpp>
+#include <mywheel/indexed_dllist.hpp>
+#include <mywheel/mapped_array.hpp>
+#include <mywheel/multi_bpqueue.hpp>
+#include <mywheel/prefetch.hpp>
+#include <mywheel/quantized_bpqueue.hpp>
+#include <mywheel/radix_heap.hpp>
+#include <mywheel/robin.hpp>
+#include <mywheel/sharded_bpqueue.hpp>
+#include <mywheel/soa_bpqueue.hpp>
+#include <mywheel/static_bpqueue.hpp>
+
+#if __has_include(<py2cpp/range.hpp>)
+#    include <mywheel/lict.hpp>
+#    define MYWHEEL_MODULE_LICT
+#endif
+
+export module mywheel;
+
+// dllist.hpp, aligned_dllist.hpp, indexed_dllist.hpp, dllink_pool.hpp, concurrent_dllist.hpp
+export using ::AlignedDllinkLayout;
+export using ::AlignedDllink;
+export using ::AlignedDllist;
+export using ::AlignedDllIterator;
+export using ::aligned_dllink_budget;
+export using ::bfs_order;
+export using ::ConcurrentDllink;
+export using ::ConcurrentDllist;
+export using ::Dllink;
+export using ::DllinkPool;
+export using ::dllink_pool_stride;
+export using ::DllinkSpinLock;
+export using ::Dllist;
+export using ::PackedDllinkLayout;
+export using ::DllIterator;
+export using ::IndexedDllink;
+export using ::IndexedDllist;
+export using ::IndexedDllIterator;
+export using ::IndexedDllPool;
+export using ::IndexedDllSequence;
+
+// bpqueue.hpp and its policies
+export using ::BitmapBucketIndex;
+export using ::bpq_key_t;
+export using ::BpqIterator;
+export using ::BpqJournal;
+export using ::BpqRange;
+export using ::BpqStats;
+export using ::BpqUndoEntry;
+export using ::BpqUndoLog;
+export using ::BpqUndoOp;
+export using ::BPQueue;
+export using ::is_lazy_bucket_index;
+export using ::LazyMax;
+export using ::LinearBucketScan;
+export using ::NoBpqJournal;
+export using ::NoBpqStats;
+export using ::prefetch_read;
+export using ::prefetch_write;
+
+// the other queues
+export using ::LinearQuantizer;
+export using ::ListSlice;
+export using ::LogQuantizer;
+export using ::MultiBPQueue;
+export using ::QuantizedBPQueue;
+export using ::quantizer_bit_length;
+export using ::RadixHeap;
+export using ::ShardedBPQueue;
+export using ::SoaBPQueue;
+export using ::StaticBPQueue;
+export using ::StaticBpqIterator;
+
+// array_like.hpp, mapped_array.hpp
+export using ::ArrayView;
+export using ::RepeatArray;
+export using ::ShiftArray;
+#if defined(__unix__) || defined(__APPLE__)
+export using ::MapMode;
+export using ::MappedFile;
+#endif
+
+export namespace fun {
+    using fun::FlatRobin;
+    using fun::Robin;
+    using fun::RobinCursor;
+}  // namespace fun
+
+#ifdef MYWHEEL_MODULE_LICT
+export namespace py {
+    using py::Lict;
+    using py::StampedLict;
+}  // namespace py
+#endif
@@ -0,0 +1,13 @@
+// Explicit instantiation definitions of the specializations declared extern in
+// <mywheel/bpqueue.hpp> when MYWHEEL_EXTERN_TEMPLATES is defined.
+#include <mywheel/bpqueue.hpp>  // for BPQueue, BpqIterator
+#include <mywheel/dllist.hpp>   // for Dllink, Dllist, DllIterator
+
+#include <cstdint>  // for int32_t, uint32_t
+#include <utility>  // for pair
+
+template class Dllink<std::pair<int, uint32_t>>;
+template class Dllist<std::pair<int, uint32_t>>;
+template class DllIterator<std::pair<int, uint32_t>>;
+template class BPQueue<int, int32_t>;
+template class BpqIterator<int, int32_t>;
@@ -0,0 +1,87 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK, Expr...
+
+#include <cstdint>                     // for int16_t, uint16_t
+#include <mywheel/aligned_dllist.hpp>  // for AlignedDllist, AlignedDllink
+#include <mywheel/bpqueue.hpp>         // for BPQueue
+#include <type_traits>                 // for is_same_v
+#include <utility>                     // for pair
+#include <vector>                      // for vector
+
+using namespace std;
+
+TEST_CASE("Test AlignedDllist") {
+    using Data = std::pair<uint16_t, uint16_t>;
+    static_assert(sizeof(Dllink<Data>) == 2 * sizeof(void *) + 4, "packed");
+    static_assert(alignof(AlignedDllink<Data>) == alignof(void *), "naturally aligned");
+    static_assert(sizeof(AlignedDllink<Data>) == aligned_dllink_budget<Data>, "padded");
+    static_assert(std::is_same_v<AlignedDllist<Data>::node_type, AlignedDllink<Data>>,
+                  "one Dllist, two layouts");
+
+    auto L1 = AlignedDllist<Data>{};
+    auto L2 = AlignedDllist<Data>{};
+    auto nodes = vector<AlignedDllink<Data>>(3);
+    CHECK(L1.is_empty());
+    L1.appendleft(nodes[1]);
+    L1.appendleft(nodes[2]);
+    L1.append(nodes[0]);  // 2 1 0
+    L2.append(L1.pop());
+    L2.append(L1.popleft());  // 0 2
+    CHECK_EQ(&L1.popleft(), &nodes[1]);
+    CHECK(L1.is_empty());
+
+    L1.splice_front(L2);
+    CHECK(L2.is_empty());
+    auto count = 0U;
+    for (const auto &_d : L1) {
+        static_assert(sizeof _d >= 0, "make compiler happy");
+        count += 1;
+    }
+    CHECK(count == 2);
+    L2.splice_back(nodes[2], nodes[2]);
+    CHECK_EQ(&L2.popleft(), &nodes[2]);
+    CHECK_EQ(&L1.popleft(), &nodes[0]);
+}
+
+struct alignas(16) Wide {
+    uint16_t v;
+};
+
+TEST_CASE("Test AlignedDllist over-aligned data") {
+    static_assert(alignof(AlignedDllink<Wide>) == 16, "aligned as the data");
+    static_assert(sizeof(AlignedDllink<Wide>) == aligned_dllink_budget<Wide>, "padded");
+
+    auto L1 = AlignedDllist<Wide>{};
+    auto nodes = vector<AlignedDllink<Wide>>(2);
+    nodes[0].data.v = 10;
+    nodes[1].data.v = 20;
+    L1.append(nodes[0]);
+    L1.append(nodes[1]);
+    CHECK_EQ(&L1.predecessor(nodes[1]), &nodes[0]);
+    CHECK_EQ(L1.pop().data.v, 20);
+    CHECK_EQ(L1.popleft().data.v, 10);
+    CHECK(L1.is_empty());
+}
+
+TEST_CASE("Test BPQueue with AlignedDllist") {
+    using Data = std::pair<uint16_t, uint16_t>;
+    using Seq = vector<AlignedDllist<Data>>;
+    auto bpq = BPQueue<uint16_t, int16_t, Seq>{-10, 10};
+    auto nodes = vector<AlignedDllink<Data>>(3);
+    bpq.append(nodes[0], 3);
+    bpq.appendleft(nodes[1], -10);
+    bpq.append(nodes[2], 10);
+    CHECK_EQ(bpq.get_max(), 10);
+    bpq.modify_key(nodes[2], -15);
+    CHECK_EQ(bpq.get_max(), 3);
+    auto count = 0;
+    for (auto &it : bpq) {
+        static_assert(sizeof(it) >= 0, "make compiler happy");
+        ++count;
+    }
+    CHECK_EQ(count, 3);
+    CHECK_EQ(&bpq.popleft(), &nodes[0]);
+    bpq.detach(nodes[1]);
+    CHECK_EQ(bpq.get_max(), -5);
+    CHECK_EQ(&bpq.popleft(), &nodes[2]);
+    CHECK(bpq.is_empty());
+}
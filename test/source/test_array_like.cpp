@@ -1,6 +1,10 @@
 #include <doctest/doctest.h>  // for ResultBuilder, TestCase, CHECK, TEST_CASE
 
+#include <iterator>                // for iterator_traits
 #include <mywheel/array_like.hpp>  // for RepeatArrat, key_iterator
+#include <numeric>                 // for reduce
+#include <type_traits>             // for is_same
+#include <vector>                  // for vector
 
 TEST_CASE("Test RepeatArray") {
     RepeatArray<int> arr(1, 10);
@@ -24,3 +28,34 @@ TEST_CASE("Test ShiftArray") {
     // }
     // CHECK_EQ(count, arr.size());
 }
+
+TEST_CASE("Test RepeatArray random access") {
+    const auto arr = RepeatArray<int>(3, 10);
+    static_assert(std::is_same<std::iterator_traits<RepeatArray<int>::Iterator>::iterator_category,
+                               std::random_access_iterator_tag>::value,
+                  "random access");
+    CHECK_EQ(arr.end() - arr.begin(), 10);
+    CHECK_EQ(*(arr.begin() + 9), 3);
+    CHECK(arr.begin() < arr.end());
+    CHECK_EQ(std::reduce(arr.begin(), arr.end()), 30);
+    CHECK_EQ(arr.sum(), 30);
+    CHECK_EQ(arr.count(3), 10U);
+    CHECK_EQ(arr.count(1), 0U);
+}
+
+TEST_CASE("Test ShiftArray contiguous") {
+    auto arr = ShiftArray<int>(std::vector<int>{1, 2, 3, 4, 5});
+    arr.set_start(2);
+    CHECK_EQ(arr.start(), 2U);
+    CHECK_EQ(arr.size(), 5U);
+    CHECK_EQ(arr.data()[2], arr[4]);
+    CHECK_EQ(std::reduce(arr.begin(), arr.end()), 15);
+    CHECK((std::vector<int>(arr.begin(), arr.end()) == std::vector<int>{1, 2, 3, 4, 5}));
+    for (auto &v : arr) {
+        v *= 2;
+    }
+    CHECK_EQ(arr[6], 10);
+#if defined(__cpp_lib_span)
+    CHECK_EQ(arr.span().size(), 5U);
+#endif
+}
@@ -1,9 +1,12 @@
 #include <doctest/doctest.h>  // for ResultBuilder, CHECK, Expression_lhs
 // #include <__config>            // for std
-#include <cstdint>  // for int32_t, uint32_t
+#include <algorithm>  // for max, min
+#include <cstdint>    // for int32_t, uint32_t
+#include <iterator>   // for back_inserter
 #include <memory>
-#include <mywheel/bpqueue.hpp>  // for BPQueue
-#include <mywheel/dllist.hpp>   // for Dllink
+#include <mywheel/bpqueue.hpp>         // for BPQueue, bpq_key_t
+#include <mywheel/dllist.hpp>          // for Dllink
+#include <mywheel/indexed_dllist.hpp>  // for IndexedDllink
 #include <type_traits>
 #include <utility>  // for pair
 #include <vector>   // for vector
@@ -80,3 +83,533 @@ TEST_CASE("Test BPQueue 3") {
         i += 1;
     }
 }
+
+TEST_CASE("Test BPQueue with BitmapBucketIndex") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    using Seq = std::vector<Dllist<std::pair<int, uint32_t>>>;
+    constexpr auto PMAX = 2000;
+
+    auto bpq1 = BPQueue<int, int32_t>{-PMAX, PMAX};
+    auto bpq2 = BPQueue<int, int32_t, Seq, BitmapBucketIndex>{-PMAX, PMAX};
+
+    auto nodes1 = vector<Item>(100);
+    auto nodes2 = vector<Item>(100);
+    for (auto i = 0; i != 100; ++i) {
+        const auto key = (i * 997) % (2 * PMAX + 1) - PMAX;
+        nodes1[size_t(i)].data.first = i;
+        nodes2[size_t(i)].data.first = i;
+        bpq1.append(nodes1[size_t(i)], key);
+        bpq2.append(nodes2[size_t(i)], key);
+    }
+    CHECK_EQ(bpq1.get_max(), bpq2.get_max());
+
+    for (auto i = 0; i < 100; i += 3) {
+        // move every third node to a key far away (possibly across many empty buckets)
+        const auto gain = int(nodes1[size_t(i)].data.second) - PMAX - 1;
+        const auto target
+            = (i % 2 == 0) ? std::max(-PMAX, gain - 1500) : std::min(PMAX, gain + 700);
+        bpq1.modify_key(nodes1[size_t(i)], target - gain);
+        bpq2.modify_key(nodes2[size_t(i)], target - gain);
+        CHECK_EQ(bpq1.get_max(), bpq2.get_max());
+    }
+
+    auto count = 0;
+    for (auto& it : bpq2) {
+        static_assert(sizeof(it) >= 0, "make compiler happy");
+        ++count;
+    }
+    CHECK_EQ(count, 100);
+
+    bpq1.detach(nodes1[42]);
+    bpq2.detach(nodes2[42]);
+    while (!bpq1.is_empty()) {
+        CHECK_EQ(bpq1.get_max(), bpq2.get_max());
+        CHECK_EQ(bpq1.popleft().data.first, bpq2.popleft().data.first);
+    }
+    CHECK(bpq2.is_empty());
+    CHECK_EQ(bpq2.get_max(), -PMAX - 1);
+}
+
+TEST_CASE("Test BitmapBucketIndex") {
+    auto bucket = std::vector<Dllist<std::pair<int, uint32_t>>>(5000);
+    auto index = BitmapBucketIndex{5000};
+    CHECK_EQ(index.find_max(bucket, 4999U), 0U);  // bucket 0 is always marked
+    index.mark(63);
+    index.mark(64);
+    index.mark(4100);
+    CHECK_EQ(index.find_max(bucket, 4999U), 4100U);
+    CHECK_EQ(index.find_max(bucket, 4099U), 64U);
+    CHECK_EQ(index.find_max(bucket, 64U), 64U);
+    CHECK_EQ(index.find_max(bucket, 63U), 63U);
+    index.unmark_if_empty(bucket, 64);
+    CHECK_EQ(index.find_max(bucket, 4099U), 63U);
+    index.clear();
+    CHECK_EQ(index.find_max(bucket, 4999U), 0U);
+}
+
+TEST_CASE("Test BPQueue modify_keys") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    constexpr auto PMAX = 10;
+    auto bpq1 = BPQueue<int, int32_t>{-PMAX, PMAX};
+    auto bpq2 = BPQueue<int, int32_t>{-PMAX, PMAX};
+
+    auto nodes1 = vector<Item>(5);
+    auto nodes2 = vector<Item>(5);
+    for (auto i = 0; i != 5; ++i) {
+        nodes1[size_t(i)].data.first = nodes2[size_t(i)].data.first = i;
+        bpq1.append(nodes1[size_t(i)], 2 * i);
+        bpq2.append(nodes2[size_t(i)], 2 * i);
+    }
+    nodes1[1].detach();
+    nodes1[1].lock();
+    nodes2[1].detach();
+    nodes2[1].lock();
+
+    const auto deltas = vector<int>{3, 5, 0, -9, -8};
+    auto items = vector<Item*>{};
+    for (auto& it : nodes2) {
+        items.push_back(&it);
+    }
+    for (auto i = 0U; i != 5U; ++i) {
+        bpq1.modify_key(nodes1[i], deltas[i]);
+    }
+    bpq2.modify_keys(items, deltas);
+
+    CHECK_EQ(bpq2.get_max(), 4);
+    CHECK(nodes2[1].is_locked());
+    while (!bpq1.is_empty()) {
+        CHECK_EQ(bpq1.get_max(), bpq2.get_max());
+        CHECK_EQ(bpq1.popleft().data.first, bpq2.popleft().data.first);
+    }
+    CHECK(bpq2.is_empty());
+}
+
+TEST_CASE("Test BPQueue reset and clear_all") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    using Seq = std::vector<Dllist<std::pair<int, uint32_t>>>;
+    auto bpq = BPQueue<int, int32_t, Seq, BitmapBucketIndex>{-100, 100};
+    auto nodes = vector<Item>(4);
+    bpq.append(nodes[0], 90);
+    bpq.append(nodes[1], -90);
+    bpq.clear_all();
+    CHECK(bpq.is_empty());
+    CHECK_EQ(bpq.get_max(), -101);
+
+    bpq.reset(-3, 3);  // shrink: storage is reused
+    CHECK(bpq.is_empty());
+    CHECK_EQ(bpq.get_max(), -4);
+    bpq.append(nodes[0], 3);
+    bpq.append(nodes[1], -3);
+    CHECK_EQ(bpq.get_max(), 3);
+    bpq.modify_key(nodes[0], -5);
+    CHECK_EQ(bpq.get_max(), -2);
+
+    bpq.reset(-1000, 1000);  // grow: storage is reallocated
+    CHECK(bpq.is_empty());
+    bpq.append(nodes[2], 1000);
+    bpq.append(nodes[3], -1000);
+    bpq.append(nodes[0], 0);
+    CHECK_EQ(bpq.get_max(), 1000);
+    CHECK_EQ(&bpq.popleft(), &nodes[2]);
+    CHECK_EQ(&bpq.popleft(), &nodes[0]);
+    CHECK_EQ(&bpq.popleft(), &nodes[3]);
+    CHECK(bpq.is_empty());
+    CHECK_EQ(bpq.get_max(), -1001);
+}
+
+TEST_CASE("Test BPQueue build") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    constexpr auto PMAX = 10;
+    auto bpq1 = BPQueue<int, int32_t>{-PMAX, PMAX};
+    auto bpq2 = BPQueue<int, int32_t>{-PMAX, PMAX};
+    auto nodes1 = vector<Item>(8);
+    auto nodes2 = vector<Item>(8);
+    const auto gains = vector<int>{3, -10, 7, 3, 0, 7, -2, 3};
+    for (auto i = 0U; i != 8U; ++i) {
+        nodes1[i].data.first = nodes2[i].data.first = int(i);
+        bpq1.append(nodes1[i], gains[i]);
+    }
+    bpq2.build(nodes2, gains);
+    CHECK_EQ(bpq2.get_max(), 7);
+    while (!bpq1.is_empty()) {
+        CHECK_EQ(bpq1.get_max(), bpq2.get_max());
+        CHECK_EQ(bpq1.popleft().data.first, bpq2.popleft().data.first);
+    }
+    CHECK(bpq2.is_empty());
+}
+
+TEST_CASE("Test BPQueue parallel build") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    constexpr auto PMAX = 10;
+    constexpr auto N = 100U;
+    auto gains = vector<int>(N);
+    for (auto i = 0U; i != N; ++i) {
+        gains[i] = int(i * 7U % 21U) - PMAX;  // many ties, spread over the chunks
+    }
+    auto nodes1 = vector<Item>(N);
+    auto bpq1 = BPQueue<int, int32_t>{-PMAX, PMAX};
+    for (auto i = 0U; i != N; ++i) {
+        nodes1[i].data.first = int(i);
+    }
+    bpq1.build(nodes1, gains);
+    for (const auto num_threads : {1U, 2U, 3U, 7U, 200U}) {
+        auto nodes2 = vector<Item>(N);
+        auto bpq2 = BPQueue<int, int32_t>{-PMAX, PMAX};
+        for (auto i = 0U; i != N; ++i) {
+            nodes2[i].data.first = int(i);
+        }
+        bpq2.build(nodes2, gains, num_threads);
+        CHECK_EQ(bpq2.get_max(), bpq1.get_max());
+        auto it1 = bpq1.begin();
+        for (auto &it2 : bpq2) {
+            CHECK_EQ(it2.data.first, (*it1).data.first);
+            ++it1;
+        }
+        CHECK(it1 == bpq1.end());
+    }
+}
+
+TEST_CASE("Test BPQueue shift_keys") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    using Seq = vector<Dllist<std::pair<int, uint32_t>>>;
+    auto bpq = BPQueue<int, int32_t, Seq, BitmapBucketIndex>{-10, 10};
+    auto nodes = vector<Item>(4);
+    for (auto i = 0U; i != 4U; ++i) {
+        nodes[i].data.first = int(i);
+    }
+    bpq.append(nodes[0], 2);
+    bpq.append(nodes[1], 2);
+    bpq.append(nodes[2], -3);
+    bpq.append(nodes[3], 5);
+
+    bpq.shift_keys(4);
+    CHECK_EQ(bpq.get_max(), 9);
+    bpq.shift_keys(-6);
+    CHECK_EQ(bpq.get_max(), 3);
+    bpq.modify_key(nodes[2], 1);  // -5 -> -4, still the minimum
+    CHECK_EQ(&bpq.popleft(), &nodes[3]);
+    CHECK_EQ(bpq.get_max(), 0);
+    CHECK_EQ(&bpq.popleft(), &nodes[0]);  // order within a bucket is kept
+    CHECK_EQ(&bpq.popleft(), &nodes[1]);
+    CHECK_EQ(bpq.get_max(), -4);
+    CHECK_EQ(&bpq.popleft(), &nodes[2]);
+    CHECK(bpq.is_empty());
+}
+
+TEST_CASE("Test BPQueue stats") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    using Seq = vector<Dllist<std::pair<int, uint32_t>>>;
+    auto bpq = BPQueue<int, int32_t, Seq, LinearBucketScan, BpqStats>{-5, 5};
+    auto nodes = vector<Item>(4);
+    bpq.append(nodes[0], 5);
+    bpq.append(nodes[1], -5);
+    bpq.append(nodes[2], 0);
+    bpq.append(nodes[3], 0);
+    CHECK_EQ(bpq.stats().size, 4U);
+    CHECK_EQ(bpq.stats().histogram[6], 2U);  // key 0
+
+    bpq.modify_key(nodes[2], 2);
+    bpq.modify_key(nodes[3], 0);
+    CHECK_EQ(bpq.stats().num_modify_key, 2U);
+    CHECK_EQ(bpq.stats().num_relink, 1U);
+    CHECK_EQ(bpq.stats().histogram[8], 1U);  // key 2
+
+    bpq.popleft();  // key 5, then walks down to key 2
+    CHECK_EQ(bpq.stats().num_popleft, 1U);
+    CHECK_EQ(bpq.stats().num_scanned, 3U);
+    bpq.detach(nodes[1]);
+    CHECK_EQ(bpq.stats().num_detach, 1U);
+    CHECK_EQ(bpq.stats().size, 2U);
+    CHECK_EQ(bpq.stats().peak_size, 4U);
+
+    bpq.clear_all();
+    CHECK_EQ(bpq.stats().size, 0U);
+    bpq.reset(-2, 2);
+    CHECK_EQ(bpq.stats().peak_size, 0U);
+    CHECK_EQ(bpq.stats().histogram.size(), 6U);
+}
+
+TEST_CASE("Test BPQueue modify_key_sorted stats and journal") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    using Seq = vector<Dllist<std::pair<int, uint32_t>>>;
+    const auto by_id
+        = [](const Item &lhs, const Item &rhs) { return lhs.data.first < rhs.data.first; };
+
+    auto bpq = BPQueue<int, int32_t, Seq, LinearBucketScan, BpqStats>{-5, 5};
+    auto nodes = vector<Item>(3);
+    for (auto i = 0U; i != 3U; ++i) {
+        nodes[i].data.first = int(i);
+    }
+    bpq.append_sorted(nodes[0], 3, by_id);
+    bpq.append_sorted(nodes[2], -5, by_id);
+    bpq.append_sorted(nodes[1], -5, by_id);
+    bpq.modify_key_sorted(nodes[0], 2, by_id);  // the sole top item: no downward search
+    CHECK_EQ(bpq.get_max(), 5);
+    CHECK_EQ(bpq.stats().num_scanned, 0U);
+    bpq.modify_key_sorted(nodes[2], 10, by_id);
+    bpq.modify_key_sorted(nodes[1], 0, by_id);
+    CHECK_EQ(bpq.stats().num_modify_key, 3U);
+    CHECK_EQ(bpq.stats().num_relink, 2U);
+    CHECK_EQ(bpq.stats().num_detach, 0U);
+    CHECK_EQ(bpq.stats().histogram[11], 2U);  // key 5, by the relinks
+    CHECK_EQ(&bpq.popleft(), &nodes[0]);  // ties by id
+    CHECK_EQ(&bpq.popleft(), &nodes[2]);
+
+    auto jbpq = BPQueue<int, int32_t, Seq, LinearBucketScan, NoBpqStats, BpqJournal>{-5, 5};
+    for (auto &it : nodes) {
+        jbpq.append_sorted(it, 0, by_id);
+    }
+    const auto cp = jbpq.checkpoint();
+    const auto logged = jbpq.undo_log().size();
+    jbpq.modify_key_sorted(nodes[1], 4, by_id);
+    jbpq.modify_key_sorted(nodes[0], 4, by_id);
+    jbpq.modify_key_sorted(nodes[1], -2, by_id);
+    CHECK_EQ(jbpq.undo_log().size() - logged, 3U);  // one relink each
+    CHECK_EQ(jbpq.get_max(), 4);
+    CHECK(jbpq.rollback_to(cp));
+    CHECK_EQ(jbpq.get_max(), 0);
+    for (auto i = 0U; i != 3U; ++i) {
+        CHECK_EQ(&jbpq.popleft(), &nodes[i]);
+    }
+}
+
+TEST_CASE("Test BPQueue with LazyMax") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    using Seq = vector<Dllist<std::pair<int, uint32_t>>>;
+    static_assert(is_lazy_bucket_index<LazyMax<BitmapBucketIndex>>::value, "lazy");
+    static_assert(!is_lazy_bucket_index<BitmapBucketIndex>::value, "eager");
+    constexpr auto PMAX = 30;
+    constexpr auto N = 50U;
+    auto bpq1 = BPQueue<int, int32_t>{-PMAX, PMAX};
+    auto bpq2 = BPQueue<int, int32_t, Seq, LazyMax<>>{-PMAX, PMAX};
+    auto bpq3 = BPQueue<int, int32_t, Seq, LazyMax<BitmapBucketIndex>>{-PMAX, PMAX};
+    auto nodes1 = vector<Item>(N);
+    auto nodes2 = vector<Item>(N);
+    auto nodes3 = vector<Item>(N);
+    auto gen = 12345U;
+    auto next = [&gen]() {
+        gen = gen * 1103515245U + 12345U;
+        return (gen >> 8) % (2 * PMAX + 1);
+    };
+    for (auto v = 0U; v != N; ++v) {
+        const auto key = int(next()) - PMAX;
+        nodes1[v].data.first = nodes2[v].data.first = nodes3[v].data.first = int(v);
+        bpq1.append(nodes1[v], key);
+        bpq2.append(nodes2[v], key);
+        bpq3.append(nodes3[v], key);
+    }
+    for (auto i = 0U; i != 300U; ++i) {
+        const auto v = next() % N;
+        if (i % 7 == 0) {
+            if (!nodes1[v].is_locked()) {
+                bpq1.detach(nodes1[v]);
+                bpq2.detach(nodes2[v]);
+                bpq3.detach(nodes3[v]);
+                nodes1[v].lock();
+                nodes2[v].lock();
+                nodes3[v].lock();
+            }
+            continue;
+        }
+        const auto target = int(next()) - PMAX;
+        const auto delta = target - (int(nodes1[v].data.second) - PMAX - 1);
+        bpq1.modify_key(nodes1[v], delta);
+        bpq2.modify_key(nodes2[v], delta);
+        bpq3.modify_key(nodes3[v], delta);
+        if (i % 10 == 0) {
+            CHECK_EQ(bpq1.get_max(), bpq2.get_max());
+            CHECK_EQ(bpq1.get_max(), bpq3.get_max());
+        }
+    }
+    while (!bpq1.is_empty()) {
+        CHECK_FALSE(bpq2.is_empty());
+        CHECK_EQ(bpq1.get_max(), bpq3.get_max());
+        const auto v = bpq1.popleft().data.first;
+        CHECK_EQ(bpq2.popleft().data.first, v);
+        CHECK_EQ(bpq3.popleft().data.first, v);
+    }
+    CHECK(bpq2.is_empty());
+    CHECK(bpq3.is_empty());
+}
+
+TEST_CASE("Test BPQueue top_k and range") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    using Seq = vector<Dllist<std::pair<int, uint32_t>>>;
+    auto bpq = BPQueue<int, int32_t, Seq, BitmapBucketIndex>{-100, 100};
+    auto nodes = vector<Item>(6);
+    const auto gains = vector<int>{-100, 40, 7, 40, 100, -3};
+    for (auto i = 0U; i != 6U; ++i) {
+        nodes[i].data.first = int(i);
+        bpq.append(nodes[i], gains[i]);
+    }
+
+    auto best = vector<Item *>{};
+    bpq.top_k(3, std::back_inserter(best));
+    CHECK_EQ(best.size(), 3U);
+    CHECK_EQ(best[0], &nodes[4]);
+    CHECK_EQ(best[1], &nodes[1]);
+    CHECK_EQ(best[2], &nodes[3]);
+    auto all = vector<Item *>(10, nullptr);
+    CHECK_EQ(bpq.top_k(10, all.begin()) - all.begin(), 6);
+    CHECK_EQ(all[5], &nodes[0]);
+    CHECK(!bpq.is_empty());  // the items stay in the queue
+
+    auto keys = vector<int>{};
+    for (auto &it : bpq.range(7)) {
+        keys.push_back(gains[size_t(it.data.first)]);
+    }
+    CHECK((keys == vector<int>{100, 40, 40, 7}));
+    auto count = 0;
+    for (auto &it : bpq.range(-100)) {
+        static_assert(sizeof(it) >= 0, "make compiler happy");
+        ++count;
+    }
+    CHECK_EQ(count, 6);
+    count = 0;
+    for (auto &it : bpq.range(101)) {
+        static_assert(sizeof(it) >= 0, "make compiler happy");
+        ++count;
+    }
+    CHECK_EQ(count, 0);
+}
+
+TEST_CASE("Test BPQueue prefetch_range and popleft_prefetch") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    using Seq = vector<Dllist<std::pair<int, uint32_t>>>;
+    using Iter = BpqIterator<int, int32_t>;
+    using PrefetchIter = BpqIterator<int, int32_t, Seq, LinearBucketScan, NoBpqStats,
+                                     NoBpqJournal, 3>;
+    static_assert(sizeof(PrefetchIter) == sizeof(Iter) + sizeof(Seq::value_type::iterator),
+                  "no lookahead stored without prefetching");
+    static_assert((prefetch_read(nullptr), prefetch_write(nullptr), true), "usable in constexpr");
+    auto bpq = BPQueue<int>{-10, 10};
+    auto nodes = vector<Item>(40);
+    for (auto i = 0U; i != 40U; ++i) {
+        nodes[i].data.first = int(i);
+        bpq.append(nodes[i], int(i % 7) - 3);  // long buckets, and some empty ones
+    }
+
+    auto expected = vector<int>{};
+    for (auto &it : bpq) {
+        expected.push_back(it.data.first);
+    }
+    auto visited = vector<int>{};
+    for (auto &it : bpq.prefetch_range<3>()) {
+        visited.push_back(it.data.first);
+    }
+    CHECK(visited == expected);
+    visited.clear();
+    for (auto &it : bpq.prefetch_range<64>(1)) {  // further than the buckets are long
+        CHECK_GE(int(it.data.first % 7) - 3, 1);
+        visited.push_back(it.data.first);
+    }
+    CHECK_EQ(visited.size(), 16U);  // keys 1, 2 and 3
+    CHECK(std::equal(visited.begin(), visited.end(), expected.begin()));
+
+    auto popped = vector<int>{};
+    while (!bpq.is_empty()) {
+        popped.push_back(bpq.popleft_prefetch().data.first);
+    }
+    CHECK(popped == expected);
+}
+
+TEST_CASE("Test BPQueue with a narrow stored key") {
+    static_assert(std::is_same<bpq_key_t<255>, uint8_t>::value, "8-bit key");
+    static_assert(std::is_same<bpq_key_t<256>, uint16_t>::value, "16-bit key");
+    static_assert(std::is_same<bpq_key_t<65536>, uint32_t>::value, "32-bit key");
+    using Data = std::pair<uint16_t, bpq_key_t<201>>;
+    using Queue = BPQueue<uint16_t, int32_t, vector<Dllist<Data>>>;
+    static_assert(Queue::key_fits(-100, 100), "201 buckets in 8 bits");
+    static_assert(!Queue::key_fits(-200, 200), "401 buckets need 16 bits");
+    static_assert(sizeof(Data) < sizeof(std::pair<uint16_t, uint32_t>), "smaller payload");
+    static_assert(sizeof(IndexedDllink<std::pair<uint16_t, uint16_t>>) == 12, "12-byte node");
+
+    auto bpq = Queue{-100, 100};
+    auto ref = BPQueue<uint16_t>{-100, 100};
+    auto nodes = vector<Dllink<Data>>(20);
+    auto ref_nodes = vector<Dllink<std::pair<uint16_t, uint32_t>>>(20);
+    for (auto i = 0U; i != 20U; ++i) {
+        const auto k = int(i * 37 % 201) - 100;
+        nodes[i].data.first = ref_nodes[i].data.first = uint16_t(i);
+        bpq.append(nodes[i], k);
+        ref.append(ref_nodes[i], k);
+    }
+    for (auto i = 0U; i < 20U; i += 3) {
+        const auto delta = i % 2 == 0 ? 7 : -5;
+        bpq.modify_key(nodes[i], delta);
+        ref.modify_key(ref_nodes[i], delta);
+    }
+    while (!ref.is_empty()) {
+        CHECK_EQ(bpq.get_max(), ref.get_max());
+        CHECK_EQ(bpq.popleft().data.first, ref.popleft().data.first);
+    }
+    CHECK(bpq.is_empty());
+}
+
+template <typename Queue> static auto snapshot(Queue &bpq) -> vector<std::pair<int, uint32_t>> {
+    auto res = vector<std::pair<int, uint32_t>>{};
+    for (auto &it : bpq) {
+        res.push_back(it.data);
+    }
+    return res;
+}
+
+template <typename BucketIndex> static auto check_rollback() -> void {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    using Seq = vector<Dllist<std::pair<int, uint32_t>>>;
+    constexpr auto PMAX = 10;
+    constexpr auto N = 20U;
+    auto bpq = BPQueue<int, int32_t, Seq, BucketIndex, NoBpqStats, BpqJournal>{-PMAX, PMAX};
+    auto nodes = vector<Item>(N + 1);
+    for (auto v = 0U; v != N; ++v) {
+        nodes[v].data.first = int(v);
+        bpq.append(nodes[v], int(v % 7) - 3);
+    }
+    const auto before = snapshot(bpq);
+    const auto max_before = bpq.get_max();
+    const auto cp = bpq.checkpoint();
+
+    bpq.modify_key(nodes[3], 4);
+    bpq.modify_key(nodes[5], -2);
+    bpq.popleft();
+    bpq.detach(nodes[9]);
+    bpq.append(nodes[N], PMAX);
+    bpq.shift_keys(-4);
+    auto items = vector<Item *>{&nodes[1], &nodes[2]};
+    auto deltas = vector<int>{3, -3};
+    bpq.modify_keys(items, deltas);
+    bpq.popleft();
+    bpq.popleft();
+    CHECK(snapshot(bpq) != before);
+
+    CHECK(bpq.rollback_to(cp));
+    CHECK((snapshot(bpq) == before));  // same items, same order
+    CHECK_EQ(bpq.get_max(), max_before);
+    CHECK_EQ(bpq.undo_log().size(), size_t(N));  // the initial appends are kept
+    CHECK_FALSE(bpq.rollback_to(cp + 1));         // no longer valid
+}
+
+TEST_CASE("Test BPQueue checkpoint and rollback_to") {
+    check_rollback<LinearBucketScan>();
+    check_rollback<BitmapBucketIndex>();
+    check_rollback<LazyMax<>>();
+
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    using Seq = vector<Dllist<std::pair<int, uint32_t>>>;
+    auto bpq = BPQueue<int, int32_t, Seq, LinearBucketScan, NoBpqStats, BpqJournal>{-5, 5};
+    bpq.undo_log().set_capacity(4);
+    auto a = Item{std::make_pair(0, uint32_t(0))};
+    bpq.append(a, 0);
+    const auto cp = bpq.checkpoint();
+    for (auto i = 0; i != 5; ++i) {
+        bpq.modify_key(a, i % 2 == 0 ? 1 : -1);
+    }
+    CHECK_FALSE(bpq.rollback_to(cp));  // overwritten in the ring
+    CHECK_EQ(bpq.get_max(), 1);
+    const auto cp2 = bpq.checkpoint();
+    bpq.modify_key(a, 2);
+    CHECK(bpq.rollback_to(cp2));
+    CHECK_EQ(bpq.get_max(), 1);
+    bpq.clear();
+    CHECK_FALSE(bpq.rollback_to(cp2));
+}
@@ -0,0 +1,62 @@
+#include <doctest/doctest.h>  // for ResultBuilder, TestCase, CHECK, TEST_CASE
+
+#include <mywheel/concurrent_dllist.hpp>  // for ConcurrentDllist, ConcurrentDllink
+#include <thread>                         // for thread
+#include <vector>                         // for vector
+
+TEST_CASE("Test ConcurrentDllist") {
+    auto L = ConcurrentDllist<int>{};
+    auto a = ConcurrentDllink<int>{3};
+    auto b = ConcurrentDllink<int>{4};
+    auto c = ConcurrentDllink<int>{5};
+    CHECK(L.is_empty());
+    CHECK(L.popleft() == nullptr);
+    L.append(a);
+    L.append(b);
+    L.appendleft(c);  // c, a, b
+    CHECK_FALSE(L.is_empty());
+    CHECK(L.detach(a));
+    CHECK(a.is_locked());
+    CHECK_FALSE(L.detach(a));  // no longer in the list
+    CHECK(L.pop() == &b);
+    CHECK(L.popleft() == &c);
+    CHECK(L.is_empty());
+}
+
+TEST_CASE("Test ConcurrentDllist with threads") {
+    constexpr auto num_threads = 4U;
+    constexpr auto per_thread = 64U;
+    auto nodes = std::vector<ConcurrentDllink<unsigned>>(num_threads * per_thread);
+    auto L = ConcurrentDllist<unsigned>{};
+    for (auto i = 0U; i != nodes.size(); ++i) {
+        nodes[i].data = i;
+        L.append(nodes[i]);
+    }
+
+    auto workers = std::vector<std::thread>{};
+    for (auto t = 0U; t != num_threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (auto round = 0U; round != 2000U; ++round) {
+                if (auto *node = L.popleft()) {
+                    L.append(*node);  // shared free list
+                }
+                auto &own = nodes[t * per_thread + round % per_thread];
+                if (L.detach(own)) {  // may be popped meanwhile by another thread
+                    L.appendleft(own);
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    auto seen = std::vector<bool>(nodes.size(), false);
+    auto count = 0U;
+    while (auto *node = L.popleft()) {
+        CHECK_FALSE(seen[node->data]);
+        seen[node->data] = true;
+        ++count;
+    }
+    CHECK_EQ(count, nodes.size());
+}
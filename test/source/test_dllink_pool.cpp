@@ -0,0 +1,56 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK, Expr...
+
+#include <cstdint>                  // for uint32_t, uintptr_t
+#include <mywheel/bpqueue.hpp>      // for BPQueue
+#include <mywheel/dllink_pool.hpp>  // for DllinkPool, bfs_order
+#include <utility>                  // for pair
+#include <vector>                   // for vector
+
+using namespace std;
+
+TEST_CASE("Test DllinkPool") {
+    using Data = std::pair<int, uint32_t>;
+    static_assert(dllink_pool_stride(sizeof(Dllink<Data>)) == 32, "24-byte nodes use 32 bytes");
+    auto pool = DllinkPool<Data>{6};  // rounded up to 8 nodes per slab
+    CHECK_EQ(pool.capacity(), 0U);
+    for (auto i = 0; i != 20; ++i) {
+        auto &node = pool.acquire(Data{i, 0U});
+        CHECK(node.is_locked());
+        const auto addr = reinterpret_cast<uintptr_t>(&node);
+        CHECK_LE(addr % 64 + sizeof(node), 64U);  // does not straddle a cache line
+    }
+    CHECK_EQ(pool.size(), 20U);
+    CHECK_EQ(pool.capacity(), 24U);
+    CHECK_EQ(pool[13].data.first, 13);
+
+    auto bpq = BPQueue<int>{-5, 5};
+    for (auto i = 0U; i != 20U; ++i) {
+        bpq.append(pool[i], int(i % 11) - 5);
+    }
+    CHECK_EQ(bpq.get_max(), 5);
+    CHECK_EQ(bpq.popleft().data.first, 10);
+    bpq.clear();
+
+    pool.release_all();
+    CHECK_EQ(pool.size(), 0U);
+    CHECK_EQ(pool.capacity(), 24U);  // the slabs are kept
+}
+
+TEST_CASE("Test DllinkPool in BFS order") {
+    // path 0 - 3 - 1 - 4, and the isolated vertex 2
+    const auto adj = vector<vector<uint32_t>>{{3}, {3, 4}, {}, {0, 1}, {1}};
+    const auto order = bfs_order(adj.size(), [&adj](uint32_t v) -> const vector<uint32_t> & {
+        return adj[v];
+    });
+    CHECK((order == vector<uint32_t>{0, 3, 1, 4, 2}));
+
+    auto pool = DllinkPool<std::pair<int, uint32_t>>{};
+    pool.place_vertices(order);
+    CHECK_EQ(pool.size(), 5U);
+    CHECK_EQ(&pool.vertex(0), &pool[0]);
+    CHECK_EQ(&pool.vertex(3), &pool[1]);
+    CHECK_EQ(&pool.vertex(2), &pool[4]);
+
+    pool.place_vertices(5);  // vertex-id order
+    CHECK_EQ(&pool.vertex(3), &pool[3]);
+}
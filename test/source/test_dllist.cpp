@@ -33,6 +33,46 @@ TEST_CASE("Test dllist") {
     CHECK(count == 2);
 }
 
+TEST_CASE("Test dllist splice") {
+    auto L1 = Dllist<std::pair<int, int>>{std::make_pair(0, 0)};
+    auto L2 = Dllist<std::pair<int, int>>{std::make_pair(0, 0)};
+    Dllink<std::pair<int, int>> nodes[5];
+    for (auto i = 0; i != 5; ++i) {
+        nodes[i].data.first = i;
+    }
+    L1.append(nodes[0]);
+    L1.append(nodes[1]);
+    L2.append(nodes[2]);
+    L2.append(nodes[3]);
+    L2.append(nodes[4]);
+
+    L1.splice_back(L2);  // 0 1 2 3 4
+    CHECK(L2.is_empty());
+    L1.splice_back(L2);  // no-op
+    auto expected = 0;
+    for (const auto &node : L1) {
+        CHECK_EQ(node.data.first, expected);
+        expected += 1;
+    }
+    CHECK_EQ(expected, 5);
+
+    L2.splice_front(nodes[1], nodes[3]);  // L1: 0 4, L2: 1 2 3
+    CHECK_EQ(L1.popleft().data.first, 0);
+    CHECK_EQ(L1.popleft().data.first, 4);
+    CHECK(L1.is_empty());
+
+    L1.append(nodes[0]);
+    L1.splice_front(L2);  // 1 2 3 0
+    CHECK(L2.is_empty());
+    L2.splice_back(nodes[3], nodes[3]);  // L1: 1 2 0, L2: 3
+    CHECK_EQ(L1.pop().data.first, 0);
+    CHECK_EQ(L1.pop().data.first, 2);
+    CHECK_EQ(L1.pop().data.first, 1);
+    CHECK(L1.is_empty());
+    CHECK_EQ(L2.popleft().data.first, 3);
+    CHECK(L2.is_empty());
+}
+
 TEST_CASE("Test Robin") {
     fun::Robin<uint8_t> rr(6U);
     auto count = 0U;
@@ -0,0 +1,133 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK, Expr...
+
+#include <cstdint>                     // for int32_t, uint32_t
+#include <mywheel/bpqueue.hpp>         // for BPQueue
+#include <mywheel/indexed_dllist.hpp>  // for IndexedDllPool, IndexedDllist
+#include <utility>                     // for pair
+
+using namespace std;
+
+TEST_CASE("Test IndexedDllist") {
+    auto pool = IndexedDllPool<std::pair<int, int>>{3, 2};
+    auto L1 = pool.list(0);
+    auto L2 = pool.list(1);
+    auto &d = pool[0];
+    auto &e = pool[1];
+    auto &f = pool[2];
+    CHECK(L1.is_empty());
+    CHECK(d.is_locked());
+
+    L1.appendleft(e);
+    CHECK(!L1.is_empty());
+    CHECK(!e.is_locked());
+
+    L1.appendleft(f);
+    L1.append(d);
+    L2.append(L1.pop());
+    L2.append(L1.popleft());
+    CHECK(!L1.is_empty());
+    CHECK(!L2.is_empty());
+    CHECK_EQ(pool.index_of(L1.popleft()), 1U);  // e
+    CHECK(L1.is_empty());
+
+    auto count = 0U;
+    for (const auto &_d : L2) {
+        static_assert(sizeof _d >= 0, "make compiler happy");
+        count += 1;
+    }
+    CHECK(count == 2);
+
+    L2.detach(d);
+    d.lock();
+    CHECK(d.is_locked());
+    CHECK_EQ(pool.index_of(L2.popleft()), 2U);  // f
+    CHECK(L2.is_empty());
+
+    L1.append(d);
+    L2.append(e);
+    L2.append(f);
+    L1.splice_front(L2);  // e f d
+    CHECK(L2.is_empty());
+    L2.splice_back(L1);
+    CHECK(L1.is_empty());
+    CHECK_EQ(pool.index_of(L2.popleft()), 1U);  // e
+    CHECK_EQ(pool.index_of(L2.popleft()), 2U);  // f
+    CHECK_EQ(pool.index_of(L2.popleft()), 0U);  // d
+    CHECK(L2.is_empty());
+}
+
+TEST_CASE("Test BPQueue with IndexedDllSequence") {
+    using Data = std::pair<int, uint32_t>;
+    using Seq = IndexedDllSequence<Data>;
+    static_assert(sizeof(IndexedDllink<Data>) == 16, "node must be 16 bytes");
+    constexpr auto PMAX = 10;
+    constexpr auto NUM_BUCKETS = size_t(2 * PMAX + 2);
+
+    // One pool for the nodes, the gain buckets (plus sentinel) and a waiting list
+    auto pool = IndexedDllPool<Data>{3, NUM_BUCKETS + 2};
+    auto bpq = BPQueue<int, int32_t, Seq>{-PMAX, PMAX, pool.buckets(0, NUM_BUCKETS)};
+    auto waiting_list = pool.list(NUM_BUCKETS + 1);
+    CHECK(bpq.is_empty());
+
+    auto &d = pool[0];
+    auto &e = pool[1];
+    auto &f = pool[2];
+    bpq.appendleft(e, 3);
+    bpq.append(f, -PMAX);
+    bpq.append(d, 5);
+    CHECK_EQ(bpq.get_max(), 5);
+
+    auto count = 0;
+    for (auto &it : bpq) {
+        static_assert(sizeof(it) >= 0, "make compiler happy");
+        ++count;
+    }
+    CHECK_EQ(count, 3);
+
+    bpq.modify_key(f, 2 * PMAX);
+    CHECK_EQ(bpq.get_max(), PMAX);
+    waiting_list.append(bpq.popleft());  // f
+    bpq.modify_key(d, -8);
+    CHECK_EQ(bpq.get_max(), 3);
+    bpq.shift_keys(-2);
+    CHECK_EQ(bpq.get_max(), 1);
+    bpq.shift_keys(2);
+    CHECK_EQ(bpq.get_max(), 3);
+    bpq.detach(e);
+    CHECK_EQ(bpq.get_max(), -3);
+    CHECK_EQ(pool.index_of(bpq.popleft()), 0U);  // d
+    CHECK(bpq.is_empty());
+    CHECK_EQ(pool.index_of(waiting_list.popleft()), 2U);
+}
+
+TEST_CASE("Test BPQueue with IndexedDllSequence, sorted and journaled") {
+    using Data = std::pair<int, uint32_t>;
+    using Seq = IndexedDllSequence<Data>;
+    using Item = IndexedDllink<Data>;
+    constexpr auto PMAX = 5;
+    constexpr auto NUM_BUCKETS = size_t(2 * PMAX + 2);
+    const auto by_id
+        = [](const Item &lhs, const Item &rhs) { return lhs.data.first < rhs.data.first; };
+
+    auto pool = IndexedDllPool<Data>{4, NUM_BUCKETS + 1};  // plus the sentinel
+    auto bpq = BPQueue<int, int32_t, Seq, LinearBucketScan, NoBpqStats, BpqJournal>{
+        -PMAX, PMAX, pool.buckets(0, NUM_BUCKETS)};
+    for (auto i = 0U; i != 4U; ++i) {
+        pool[i].data.first = int(3 - i);  // ids 3 2 1 0
+        bpq.append_sorted(pool[i], 1, by_id);
+    }
+    CHECK_EQ(pool.index_of(bpq.front()), 3U);  // id 0
+
+    const auto cp = bpq.checkpoint();
+    bpq.modify_key_sorted(pool[3], 2, by_id);
+    bpq.modify_key_sorted(pool[1], 2, by_id);
+    CHECK_EQ(bpq.get_max(), 3);
+    CHECK_EQ(pool.index_of(bpq.front()), 3U);  // id 0 before id 2
+    bpq.detach(pool[0]);
+    CHECK(bpq.rollback_to(cp));
+    CHECK_EQ(bpq.get_max(), 1);
+    for (auto i = 4U; i != 0U; --i) {
+        CHECK_EQ(pool.index_of(bpq.popleft()), i - 1);  // ids 0 1 2 3
+    }
+    CHECK(bpq.is_empty());
+}
@@ -1,7 +1,9 @@
 #include <doctest/doctest.h>  // for ResultBuilder, TestCase, CHECK, TEST_CASE
 
+#include <cstdint>           // for uintptr_t
 #include <mywheel/lict.hpp>  // for Lict, key_iterator
-#include <vector>
+#include <utility>           // for as_const
+#include <vector>            // for vector
 
 TEST_CASE("Test Lict") {
     const auto S = py::Lict<double>{std::vector<double>{0.6, 0.7, 0.8}};
@@ -14,3 +16,61 @@ TEST_CASE("Test Lict") {
     }
     CHECK(count == 3);
 }
+
+TEST_CASE("Test StampedLict") {
+    auto S = py::StampedLict<int>{5, -1};
+    CHECK_EQ(S.size(), 5U);
+    CHECK_EQ(std::as_const(S)[3], -1);
+    S[3] = 7;
+    S[1] += 2;  // starts from the default value
+    S[3] = 8;
+    CHECK_EQ(std::as_const(S)[3], 8);
+    CHECK_EQ(S.at(1), 1);
+    CHECK(S.is_touched(1));
+    CHECK_FALSE(S.is_touched(0));
+    CHECK((S.touched() == std::vector<size_t>{3, 1}));
+
+    S.clear();
+    CHECK(S.touched().empty());
+    CHECK_EQ(std::as_const(S)[3], -1);
+    CHECK_FALSE(S.is_touched(3));
+    S[4] = 5;
+    CHECK_EQ(S.at(4), 5);
+    CHECK_EQ(S.at(1), -1);
+    CHECK_EQ(S.touched().size(), 1U);
+}
+
+TEST_CASE("Test Lict chunks") {
+    auto S = py::Lict<int>{std::vector<int>(1000, 0)};
+    const auto ranges = S.chunks(4);
+    CHECK(!ranges.empty());
+    CHECK(ranges.size() <= 4U);
+    auto next = size_t(0);
+    for (const auto &rng : ranges) {
+        CHECK_EQ(*rng.begin(), next);
+        const auto addr = reinterpret_cast<std::uintptr_t>(&S.values()[*rng.begin()]);
+        CHECK((next == 0 || addr % S.cache_line_size == 0));  // no false sharing
+        for (const auto &key : rng) {
+            next = key + 1;
+        }
+    }
+    CHECK_EQ(next, S.size());
+    CHECK_EQ(S.chunks(1).size(), 1U);
+    CHECK((py::Lict<int>{std::vector<int>{1, 2}}.chunks(8).size() == 1U));
+
+    struct Rgb {
+        int r, g, b;  // 12 bytes, which don't divide a cache line
+    };
+    auto colors = py::Lict<Rgb>{std::vector<Rgb>(1000)};
+    const auto color_ranges = colors.chunks(5);
+    CHECK(color_ranges.size() > 1U);
+    for (const auto &rng : color_ranges) {
+        const auto addr = reinterpret_cast<std::uintptr_t>(&colors.values()[*rng.begin()]);
+        CHECK((*rng.begin() == 0 || addr % colors.cache_line_size == 0));
+    }
+
+    S.parallel_for_each_item([](size_t key, int &value) { value = int(key) * 2; }, 4);
+    for (const auto &key : S) {
+        CHECK_EQ(S[key], int(key) * 2);
+    }
+}
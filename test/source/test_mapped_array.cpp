@@ -0,0 +1,73 @@
+#include <doctest/doctest.h>  // for ResultBuilder, TestCase, CHECK, TEST_CASE
+
+#include <cstdint>                   // for int32_t
+#include <cstdio>                    // for remove
+#include <filesystem>                // for temp_directory_path
+#include <fstream>                   // for ofstream, ifstream
+#include <mywheel/array_like.hpp>    // for ShiftArray
+#include <mywheel/lict.hpp>          // for Lict
+#include <mywheel/mapped_array.hpp>  // for ArrayView, MappedFile
+#include <stdexcept>                 // for out_of_range
+#include <string>                    // for string
+#include <vector>                    // for vector
+
+TEST_CASE("Test ArrayView backing") {
+    auto data = std::vector<int>{1, 4, 3, 6};
+    auto L = py::Lict<int, ArrayView<int>>{ArrayView<int>{data}};
+    CHECK_EQ(L.size(), 4U);
+    L[2] = 7;
+    CHECK_EQ(data[2], 7);  // no copy
+    CHECK_THROWS_AS((void)L.at(4), std::out_of_range);
+
+    const auto R = py::Lict<int, ArrayView<const int>>{ArrayView<const int>{data}};
+    CHECK_EQ(R[2], 7);
+    auto sum = 0;
+    for (const auto &v : R.values()) {
+        sum += v;
+    }
+    CHECK_EQ(sum, 18);
+
+    auto S = ShiftArray<int, ArrayView<int>>{ArrayView<int>{data}};
+    S.set_start(2);
+    S[3] = 5;
+    CHECK_EQ(data[1], 5);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("Test MappedFile") {
+    const auto path = (std::filesystem::temp_directory_path() / "mywheel_test_mapped.bin").string();
+    {
+        const auto data = std::vector<int32_t>{10, 20, 30, 40};
+        auto out = std::ofstream(path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(data.data()),
+                  static_cast<std::streamsize>(data.size() * sizeof(int32_t)));
+    }
+
+    {
+        const auto file = MappedFile{path.c_str()};
+        CHECK_EQ(file.size(), 4 * sizeof(int32_t));
+        const auto L = py::Lict<int32_t, ArrayView<const int32_t>>{file.view<int32_t>()};
+        CHECK_EQ(L.size(), 4U);
+        CHECK_EQ(L[3], 40);
+    }
+
+    {
+        auto file = MappedFile{path.c_str(), MapMode::copy_on_write};
+        auto S = ShiftArray<int32_t, ArrayView<int32_t>>{file.mutable_view<int32_t>()};
+        S.set_start(1);
+        S[1] = -1;
+        CHECK_EQ(S[1], -1);
+    }
+    CHECK_EQ(MappedFile{path.c_str()}.view<int32_t>()[0], 10);  // not written back
+
+    {
+        auto file = MappedFile{path.c_str(), MapMode::read_write};
+        auto L = py::Lict<int32_t, ArrayView<int32_t>>{file.mutable_view<int32_t>()};
+        L[0] = 11;
+    }
+    CHECK_EQ(MappedFile{path.c_str()}.view<int32_t>()[0], 11);  // written back
+
+    std::remove(path.c_str());
+    CHECK_THROWS_AS(MappedFile{path.c_str()}, std::system_error);
+}
+#endif
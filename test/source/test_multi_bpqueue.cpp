@@ -0,0 +1,83 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK, Expr...
+
+#include <cstdint>                    // for int32_t, uint32_t
+#include <mywheel/multi_bpqueue.hpp>  // for MultiBPQueue
+#include <random>                     // for mt19937
+#include <utility>                    // for pair
+#include <vector>                     // for vector
+
+using namespace std;
+
+TEST_CASE("Test MultiBPQueue") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    auto mbpq = MultiBPQueue<int, int32_t>{-10, 10, 3};
+    CHECK_EQ(mbpq.num_parts(), 3U);
+    CHECK(mbpq.is_empty());
+    CHECK_EQ(mbpq.get_max(), -11);
+
+    auto nodes = vector<Item>(6);
+    mbpq.append(0, nodes[0], 2);
+    mbpq.append(1, nodes[1], 5);
+    mbpq.append(2, nodes[2], 5);
+    mbpq.append(2, nodes[3], -4);
+    CHECK_EQ(mbpq.get_max(), 5);
+    CHECK_EQ(mbpq.get_max_part(), 1U);  // ties are won by the lower part
+
+    mbpq.modify_key(0, nodes[0], 7);
+    CHECK_EQ(mbpq.get_max(), 9);
+    CHECK_EQ(mbpq.get_max_part(), 0U);
+    auto res = mbpq.pop_global_max();
+    CHECK_EQ(res.first, 0U);
+    CHECK_EQ(res.second, &nodes[0]);
+    CHECK(mbpq.queue(0).is_empty());
+
+    mbpq.detach(1, nodes[1]);
+    CHECK_EQ(mbpq.get_max_part(), 2U);
+    res = mbpq.pop_global_max();
+    CHECK_EQ(res.second, &nodes[2]);
+    CHECK_EQ(mbpq.get_max(), -4);
+    mbpq.clear();
+    CHECK(mbpq.is_empty());
+}
+
+TEST_CASE("Test MultiBPQueue against linear scan") {
+    using Item = Dllink<std::pair<int, uint32_t>>;
+    constexpr auto PMAX = 20;
+    constexpr auto K = 5U;
+    constexpr auto N = 40U;
+    auto mbpq = MultiBPQueue<int, int32_t, BitmapBucketIndex>{-PMAX, PMAX, K};
+    auto nodes = vector<Item>(K * N);
+    auto gen = std::mt19937{7};  // NOLINT(cert-msc32-c, cert-msc51-cpp)
+    for (auto p = 0U; p != K; ++p) {
+        for (auto v = 0U; v != N; ++v) {
+            mbpq.append(p, nodes[p * N + v], int(gen() % (2 * PMAX + 1)) - PMAX);
+        }
+    }
+    for (auto i = 0U; i != 200U; ++i) {
+        const auto p = gen() % K;
+        auto &it = nodes[p * N + gen() % N];
+        if (!it.is_locked()) {
+            const auto key = int(it.data.second) - PMAX - 1;
+            const auto target = int(gen() % (2 * PMAX + 1)) - PMAX;
+            mbpq.modify_key(p, it, target - key);
+        }
+        if (i % 4 == 0) {
+            auto best = 0U;
+            for (auto q = 1U; q != K; ++q) {
+                if (mbpq.queue(best).get_max() < mbpq.queue(q).get_max()) {
+                    best = q;
+                }
+            }
+            CHECK_EQ(mbpq.get_max(), mbpq.queue(best).get_max());
+            CHECK_EQ(mbpq.get_max_part(), best);
+            mbpq.pop_global_max().second->lock();
+        }
+    }
+    auto last = PMAX;
+    while (!mbpq.is_empty()) {
+        const auto key = mbpq.get_max();
+        CHECK_LE(key, last);
+        last = key;
+        mbpq.pop_global_max();
+    }
+}
@@ -0,0 +1,87 @@
+#include <doctest/doctest.h>  // for ResultBuilder, TestCase, CHECK, TEST_CASE
+
+#include <cstdint>                        // for int32_t, uint32_t
+#include <mywheel/quantized_bpqueue.hpp>  // for QuantizedBPQueue, LinearQuantizer, LogQuantizer
+#include <utility>                        // for pair
+#include <vector>                         // for vector
+
+using Item = Dllink<std::pair<int, uint32_t>>;
+
+TEST_CASE("Test LinearQuantizer and LogQuantizer") {
+    const auto lin = LinearQuantizer<int32_t>{-1000000, 1000000, 1024};
+    CHECK_EQ(lin(-1000000), 1U);
+    CHECK(lin(1000000) <= 1024U);
+    CHECK_EQ(lin.max_error(), 2047U);
+
+    const auto log = LogQuantizer<int32_t>{-1000000, 1000000, 256};
+    CHECK(log(1000000) <= 256U);
+    CHECK(log.mantissa_bits() >= 3U);
+    auto prev = log(-1000000);
+    CHECK_EQ(prev, 1U);
+    for (auto g = -1000000; g <= 1000000; g += 7) {
+        const auto b = log(g);
+        CHECK(b >= prev);  // non-decreasing
+        prev = b;
+    }
+    const auto small = (1 << log.mantissa_bits()) - 1;
+    for (auto g = -small; g < small; ++g) {
+        CHECK(log(g) < log(g + 1));  // small keys are exact
+    }
+    const auto exact = LogQuantizer<int32_t>{-5, 5, 100};
+    CHECK_EQ(exact(5) - exact(-5), 10U);
+}
+
+TEST_CASE("Test QuantizedBPQueue") {
+    constexpr auto PMAX = 1000000;
+    auto bpq = QuantizedBPQueue<int, int32_t>{-PMAX, PMAX, 1024};
+    CHECK(bpq.num_buckets() <= 1024U);
+    CHECK(bpq.is_empty());
+    CHECK_EQ(bpq.get_max(), -PMAX - 1);
+
+    constexpr auto N = 200U;
+    auto nodes = std::vector<Item>(N);
+    auto gen = 12345U;
+    for (auto v = 0U; v != N; ++v) {
+        gen = gen * 1103515245U + 12345U;
+        nodes[v].data.first = int(v);
+        bpq.append(nodes[v], int((gen >> 4) % (2 * PMAX + 1)) - PMAX);
+    }
+    bpq.modify_key(nodes[7], 3);   // stays in its bucket
+    bpq.modify_key(nodes[8], -PMAX / 2 < bpq.get_key(nodes[8]) ? -PMAX / 2 : PMAX / 2);
+    const auto err = int(bpq.quantizer().max_error());
+
+    // bounded error
+    auto max = bpq.get_max();
+    auto &it = bpq.popleft();
+    CHECK(bpq.get_key(it) <= max);
+    CHECK(bpq.get_key(it) >= max - err);
+
+    // exact
+    auto prev = bpq.get_max();
+    auto count = 1U;
+    while (!bpq.is_empty()) {
+        auto &top = bpq.popleft_exact();
+        CHECK(bpq.get_key(top) <= prev);
+        prev = bpq.get_key(top);
+        ++count;
+    }
+    CHECK_EQ(count, N);
+}
+
+TEST_CASE("Test QuantizedBPQueue with LogQuantizer") {
+    auto bpq = QuantizedBPQueue<int, int32_t, LogQuantizer<int32_t>, BitmapBucketIndex>{
+        -100000, 100000, 128};
+    auto a = Item{std::make_pair(0, uint32_t(0))};
+    auto b = Item{std::make_pair(1, uint32_t(0))};
+    auto c = Item{std::make_pair(2, uint32_t(0))};
+    bpq.append(a, 3);
+    bpq.append(b, 90000);
+    bpq.append(c, 4);
+    CHECK_EQ(bpq.get_max(), 90000);
+    bpq.modify_key(b, -89999);  // now 1
+    CHECK_EQ(bpq.get_max(), 4);
+    CHECK_EQ(&bpq.popleft(), &c);  // small keys are in exact order
+    bpq.detach(a);
+    CHECK_EQ(&bpq.popleft(), &b);
+    CHECK(bpq.is_empty());
+}
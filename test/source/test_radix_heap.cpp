@@ -0,0 +1,67 @@
+#include <doctest/doctest.h>  // for ResultBuilder, TestCase, CHECK, TEST_CASE
+
+#include <cstdint>                 // for int32_t, uint32_t
+#include <mywheel/bpqueue.hpp>     // for BPQueue
+#include <mywheel/radix_heap.hpp>  // for RadixHeap
+#include <utility>                 // for pair
+#include <vector>                  // for vector
+
+using Item = Dllink<std::pair<int, uint32_t>>;
+
+TEST_CASE("Test RadixHeap") {
+    auto rh = RadixHeap<int, int32_t>{-1000000, 1000000};
+    auto a = Item{std::make_pair(0, uint32_t(0))};
+    auto b = Item{std::make_pair(1, uint32_t(0))};
+    auto c = Item{std::make_pair(2, uint32_t(0))};
+    CHECK(rh.is_empty());
+    rh.append(a, 5);
+    rh.append(b, -700000);
+    rh.append(c, 5);
+    CHECK_EQ(rh.size(), 3U);
+    CHECK_EQ(rh.get_max(), 5);
+    CHECK_EQ(&rh.popleft(), &a);  // FIFO on ties
+    rh.modify_key(c, -10);
+    CHECK_EQ(rh.get_key(c), -5);
+    rh.modify_key(b, 699990);  // -10, still below the last popped key
+    CHECK_EQ(&rh.popleft(), &c);
+    rh.detach(b);
+    CHECK(rh.is_empty());
+    rh.clear();
+    rh.append(a, 1000000);  // the bounds are back
+    CHECK_EQ(rh.get_max(), 1000000);
+}
+
+TEST_CASE("Test RadixHeap against BPQueue") {
+    constexpr auto PMAX = 500;
+    constexpr auto N = 300U;
+    auto rh = RadixHeap<int, int32_t>{-PMAX, PMAX};
+    auto bpq = BPQueue<int, int32_t>{-PMAX, PMAX};
+    auto nodes1 = std::vector<Item>(N);
+    auto nodes2 = std::vector<Item>(N);
+    auto gen = 12345U;
+    auto next = [&gen](uint32_t n) {
+        gen = gen * 1103515245U + 12345U;
+        return (gen >> 8) % n;
+    };
+    for (auto v = 0U; v != N / 2; ++v) {
+        const auto key = int(next(2 * PMAX + 1)) - PMAX;
+        rh.append(nodes1[v], key);
+        bpq.append(nodes2[v], key);
+    }
+    auto added = N / 2;
+    auto prev = PMAX;
+    while (!bpq.is_empty()) {
+        CHECK_EQ(rh.get_max(), bpq.get_max());
+        prev = bpq.get_max();
+        rh.popleft();
+        bpq.popleft();
+        if (added != N && prev > -PMAX) {  // new keys below the last popped one
+            const auto key = prev - int(next(uint32_t(prev + PMAX))) - 1;
+            rh.append(nodes1[added], key);
+            bpq.append(nodes2[added], key);
+            ++added;
+        }
+    }
+    CHECK(rh.is_empty());
+    CHECK_EQ(added, N);
+}
@@ -3,6 +3,7 @@
 #include <cinttypes>          // for uint8_t
 #include <mywheel/robin.hpp>  // for Robin, Robin<>::iterable_w...
 #include <utility>            // for pair
+#include <vector>             // for vector
 
 using namespace std;
 
@@ -15,3 +16,76 @@ TEST_CASE("Test Robin") {
     }
     CHECK(count == 5);
 }
+
+TEST_CASE("Test FlatRobin") {
+    const fun::Robin<uint8_t> rr(6U);
+    constexpr fun::FlatRobin<uint8_t> fr(6U);
+    for (auto from_part = uint8_t(0); from_part != 6U; ++from_part) {
+        auto it = rr.exclude(from_part).begin();
+        auto count = 0U;
+        for (const auto to_part : fr.exclude(from_part)) {
+            CHECK_EQ(to_part, *it);
+            ++it;
+            count += 1;
+        }
+        CHECK(count == 5);
+
+        it = rr.exclude(from_part).begin();
+        const auto wrapper = fr.exclude(from_part);
+        for (const auto to_part : wrapper.first()) {
+            CHECK_EQ(to_part, *it);
+            ++it;
+        }
+        for (const auto to_part : wrapper.second()) {
+            CHECK_EQ(to_part, *it);
+            ++it;
+        }
+        CHECK(it == rr.exclude(from_part).end());
+
+        it = rr.exclude(from_part).begin();
+        fr.for_each_excluding(from_part, [&it](uint8_t to_part) {
+            CHECK_EQ(to_part, *it);
+            ++it;
+        });
+        CHECK(it == rr.exclude(from_part).end());
+    }
+}
+
+TEST_CASE("Test Robin with rotating cursor") {
+    const fun::Robin<uint8_t> rr(6U);
+    for (auto from_part = uint8_t(0); from_part != 6U; ++from_part) {
+        auto plain = vector<uint8_t>{};
+        for (const auto to_part : rr.exclude(from_part)) {
+            plain.push_back(to_part);
+        }
+        auto cursor = fun::RobinCursor<uint8_t>{};
+        auto firsts = vector<int>(6, 0);
+        for (auto round = 0U; round != 10U; ++round) {
+            auto i = round % 5U;
+            auto count = 0U;
+            for (const auto to_part : rr.exclude(from_part, cursor)) {
+                CHECK_EQ(to_part, plain[i]);
+                if (count == 0) {
+                    firsts[to_part] += 1;
+                }
+                i = (i + 1) % 5U;
+                count += 1;
+            }
+            CHECK(count == 5);
+            cursor.next_round();
+        }
+        CHECK_EQ(firsts[from_part], 0);  // the starting points are spread evenly
+        for (auto to_part = 0U; to_part != 6U; ++to_part) {
+            if (to_part != from_part) {
+                CHECK_EQ(firsts[to_part], 2);
+            }
+        }
+    }
+
+    const fun::Robin<uint8_t> single(1U);
+    auto count = 0U;
+    for ([[maybe_unused]] auto _i : single.exclude(0, fun::RobinCursor<uint8_t>{3})) {
+        count += 1;
+    }
+    CHECK(count == 0);
+}
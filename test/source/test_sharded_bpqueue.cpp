@@ -0,0 +1,145 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK, Expression_lhs
+
+#include <atomic>                       // for atomic
+#include <cstdint>                      // for int32_t, uint32_t
+#include <mywheel/sharded_bpqueue.hpp>  // for ShardedBPQueue
+#include <thread>                       // for thread
+#include <utility>                      // for pair
+#include <vector>                       // for vector
+
+using Item = Dllink<std::pair<int, uint32_t>>;
+
+TEST_CASE("Test ShardedBPQueue") {
+    constexpr auto PMAX = 10;
+    auto bpq = ShardedBPQueue<int, int32_t>{-PMAX, PMAX, 3};
+    CHECK(bpq.is_empty());
+    CHECK_EQ(bpq.try_pop_max().first, nullptr);
+
+    auto nodes = std::vector<Item>(9);
+    for (auto v = 0U; v != 9U; ++v) {
+        nodes[v].data.first = int(v);
+        bpq.append(v % 3, nodes[v], int(v) - 4);
+    }
+    CHECK_EQ(bpq.get_max(), 4);
+    bpq.modify_key(0, nodes[0], 10);  // -4 -> 6
+    bpq.detach(1, nodes[7]);
+    CHECK_EQ(bpq.get_max(), 6);
+
+    auto prev = PMAX + 1;
+    auto count = 0;
+    for (auto res = bpq.try_pop_max(); res.first != nullptr; res = bpq.try_pop_max()) {
+        CHECK_EQ(size_t(res.first->data.first) % 3, res.second);
+        const auto key = int(res.first->data.second) - PMAX - 1;
+        CHECK(key <= prev);  // descending when single-threaded
+        prev = key;
+        ++count;
+    }
+    CHECK_EQ(count, 8);
+    CHECK(bpq.is_empty());
+}
+
+TEST_CASE("Test ShardedBPQueue with threads") {
+    constexpr auto PMAX = 100;
+    constexpr auto NUM_THREADS = 4U;
+    constexpr auto N = 4000U;
+    auto bpq = ShardedBPQueue<int, int32_t>{-PMAX, PMAX, NUM_THREADS};
+    auto nodes = std::vector<Item>(N);
+    auto popped = std::vector<std::atomic<int>>(N);
+
+    auto workers = std::vector<std::thread>{};
+    for (auto t = 0U; t != NUM_THREADS; ++t) {
+        workers.emplace_back([&, t]() {
+            for (auto v = t; v < N; v += NUM_THREADS) {
+                nodes[v].data.first = int(v);
+                bpq.append(t, nodes[v], int(v % 199U) - PMAX + 1);
+            }
+            for (auto v = t; v < N; v += 2 * NUM_THREADS) {
+                bpq.modify_key(t, nodes[v], (int(v) % 3) - 1);
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    workers.clear();
+    for (auto t = 0U; t != NUM_THREADS; ++t) {
+        workers.emplace_back([&]() {
+            for (auto res = bpq.try_pop_max(); res.first != nullptr; res = bpq.try_pop_max()) {
+                popped[size_t(res.first->data.first)] += 1;
+            }
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    CHECK(bpq.is_empty());
+    auto ok = true;
+    for (auto &p : popped) {
+        ok = ok && p.load() == 1;
+    }
+    CHECK(ok);
+}
+
+/**
+ * @brief Build a queue over num_shards shards with num_threads threads, update it, and pop it
+ * in the deterministic order
+ */
+static auto pop_sequence(size_t num_shards, size_t num_threads)
+    -> std::vector<std::pair<int, int>> {
+    constexpr auto PMAX = 20;
+    constexpr auto N = 500U;
+    auto bpq = ShardedBPQueue<int, int32_t>{-PMAX, PMAX, num_shards};
+    auto nodes = std::vector<Item>(N);
+    auto gains = std::vector<int>(N);
+    for (auto v = 0U; v != N; ++v) {
+        nodes[v].data.first = int(v);
+        gains[v] = int(v * 7U % 41U) - PMAX;
+    }
+    bpq.build(nodes, gains, num_threads);
+    for (auto v = 0U; v < N; v += 3) {
+        const auto delta = gains[v] < 0 ? 5 : -5;  // FIFO and LIFO relinks
+        bpq.modify_key_ordered(v % num_shards, nodes[v], delta);
+        gains[v] += delta;
+    }
+    auto res = std::vector<std::pair<int, int>>{};
+    for (auto p = bpq.try_pop_max_ordered(); p.first != nullptr; p = bpq.try_pop_max_ordered()) {
+        CHECK_EQ(size_t(p.first->data.first) % num_shards, p.second);
+        res.emplace_back(gains[size_t(p.first->data.first)], p.first->data.first);
+    }
+    CHECK(bpq.is_empty());
+    return res;
+}
+
+TEST_CASE("Test ShardedBPQueue deterministic build and pop order") {
+    const auto expected = pop_sequence(1, 1);
+    CHECK_EQ(expected.size(), 500U);
+    auto sorted = true;
+    for (auto i = size_t(1); i < expected.size(); ++i) {
+        const auto &a = expected[i - 1];
+        const auto &b = expected[i];
+        sorted = sorted && (a.first > b.first || (a.first == b.first && a.second < b.second));
+    }
+    CHECK(sorted);  // by (key, vertex id)
+    CHECK(pop_sequence(4, 1) == expected);
+    CHECK(pop_sequence(4, 4) == expected);
+    CHECK(pop_sequence(7, 3) == expected);
+}
+
+TEST_CASE("Test ShardedBPQueue ordered by a custom vertex id") {
+    struct ReversedId {
+        auto operator()(const Item &it) const noexcept -> int { return -it.data.first; }
+    };
+    auto bpq = ShardedBPQueue<int, int32_t, std::vector<Dllist<std::pair<int, uint32_t>>>,
+                              LinearBucketScan, ReversedId>{-5, 5, 2};
+    auto nodes = std::vector<Item>(6);
+    for (auto v = 0U; v != 6U; ++v) {
+        nodes[v].data.first = int(v);
+        bpq.append_ordered(v % 2, nodes[v], 1);
+    }
+    bpq.modify_key_ordered(0, nodes[2], 2);
+    auto popped = std::vector<int>{};
+    for (auto p = bpq.try_pop_max_ordered(); p.first != nullptr; p = bpq.try_pop_max_ordered()) {
+        popped.push_back(p.first->data.first);
+    }
+    CHECK(popped == std::vector<int>{2, 5, 4, 3, 1, 0});
+}
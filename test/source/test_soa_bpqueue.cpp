@@ -0,0 +1,96 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK, Expression_lhs
+
+#include <cstdint>                  // for int32_t, uint32_t
+#include <mywheel/soa_bpqueue.hpp>  // for SoaBPQueue
+#include <vector>                   // for vector
+
+TEST_CASE("Test SoaBPQueue") {
+    constexpr auto PMAX = 10;
+    auto bpq1 = SoaBPQueue<int, int32_t>{-PMAX, PMAX, 3};
+    auto bpq2 = SoaBPQueue<int, int32_t>{-PMAX, PMAX, 3};
+    CHECK(bpq1.is_empty());
+    CHECK(bpq1.is_locked(0));
+
+    const auto d = 0U;
+    const auto e = 1U;
+    const auto f = 2U;
+    bpq1.payload(d) = 42;
+    bpq1.appendleft(e, 3);
+    bpq1.append(f, -PMAX);
+    bpq1.append(d, 5);
+    CHECK_EQ(bpq1.get_max(), 5);
+    CHECK_EQ(bpq1.get_key(f), -PMAX);
+
+    bpq2.append(bpq1.popleft(), -6);  // d
+    bpq2.append(bpq1.popleft(), 3);   // e
+    bpq2.append(bpq1.popleft(), 0);   // f
+    CHECK(bpq1.is_empty());
+    CHECK_EQ(bpq1.payload(d), 42);
+
+    bpq2.modify_key(d, 15);
+    bpq2.modify_key(d, -3);
+    CHECK_EQ(bpq2.get_max(), 6);
+    CHECK_EQ(bpq2.get_key(d), 6);
+
+    bpq2.detach(d);
+    CHECK_EQ(bpq2.get_max(), 3);
+    bpq2.lock(d);
+    bpq2.modify_key(d, 1);  // ignored
+    CHECK_EQ(bpq2.get_max(), 3);
+    CHECK_EQ(bpq2.popleft(), e);
+    CHECK_EQ(bpq2.popleft(), f);
+    CHECK(bpq2.is_empty());
+    CHECK_EQ(bpq2.get_max(), -PMAX - 1);
+}
+
+TEST_CASE("Test SoaBPQueue with BitmapBucketIndex") {
+    constexpr auto PMAX = 2000;
+    constexpr auto N = 100U;
+    auto bpq = SoaBPQueue<int, int32_t, BitmapBucketIndex>{-PMAX, PMAX, N};
+    for (auto v = 0U; v != N; ++v) {
+        bpq.appendleft(v, int(v * 37U % 4001U) - PMAX);
+    }
+    bpq.modify_key(7, -1);
+    bpq.clear();
+    CHECK(bpq.is_empty());
+    for (auto v = 0U; v != N; ++v) {
+        bpq.append(v, int(v) * 40 - PMAX);
+    }
+    auto prev = PMAX + 1;
+    for (auto v = 0U; v != N; ++v) {
+        CHECK(bpq.get_max() < prev);
+        prev = bpq.get_max();
+        CHECK_EQ(bpq.popleft(), N - 1U - v);
+    }
+    CHECK(bpq.is_empty());
+}
+
+TEST_CASE("Test SoaBPQueue modify_keys") {
+    constexpr auto PMAX = 10;
+    auto bpq = SoaBPQueue<int, int32_t>{-PMAX, PMAX, 4};
+    for (auto v = 0U; v != 4U; ++v) {
+        bpq.append(v, int(v) * 3);
+    }
+    bpq.detach(0);
+    bpq.lock(0);
+    bpq.modify_keys(std::vector<uint32_t>{0, 1, 2, 3}, std::vector<int>{7, 2, -1, -9});
+    CHECK_EQ(bpq.get_key(0), 0);
+    CHECK_EQ(bpq.get_max(), 5);
+    CHECK_EQ(bpq.popleft(), 1U);  // increased: LIFO
+    CHECK_EQ(bpq.popleft(), 2U);  // decreased: FIFO
+    CHECK_EQ(bpq.popleft(), 3U);
+    CHECK(bpq.is_empty());
+}
+
+TEST_CASE("Test SoaBPQueue build") {
+    constexpr auto PMAX = 10;
+    auto bpq = SoaBPQueue<int, int32_t>{-PMAX, PMAX, 5};
+    bpq.build(std::vector<int>{2, -10, 7, 2, 0});
+    CHECK_EQ(bpq.get_max(), 7);
+    CHECK_EQ(bpq.popleft(), 2U);
+    CHECK_EQ(bpq.popleft(), 0U);  // same key: input order
+    CHECK_EQ(bpq.popleft(), 3U);
+    CHECK_EQ(bpq.popleft(), 4U);
+    CHECK_EQ(bpq.popleft(), 1U);
+    CHECK(bpq.is_empty());
+}
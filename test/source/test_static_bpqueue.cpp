@@ -0,0 +1,106 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK, Expression_lhs
+
+#include <cstdint>                     // for int8_t, int32_t, uint8_t, uint32_t
+#include <iterator>                    // for back_inserter
+#include <mywheel/bpqueue.hpp>         // for BPQueue
+#include <mywheel/static_bpqueue.hpp>  // for StaticBPQueue
+#include <utility>                     // for pair
+#include <vector>                      // for vector
+
+using Item = Dllink<std::pair<int, uint32_t>>;
+
+/**
+ * @brief Same code for both queue types
+ */
+template <typename Queue> auto play(Queue &bpq, std::vector<Item> &nodes) -> int {
+    bpq.appendleft(nodes[0], 3);
+    bpq.append(nodes[1], -3);
+    bpq.append(nodes[2], 1);
+    bpq.modify_key(nodes[1], 5);  // 2
+    bpq.modify_key(nodes[0], -4);  // -1
+    auto count = 0;
+    for (auto &it : bpq) {
+        static_assert(sizeof(it) >= 0, "make compiler happy");
+        ++count;
+    }
+    CHECK_EQ(count, 3);
+    return bpq.popleft().data.first * 10 + bpq.get_max();
+}
+
+constexpr auto compile_time_play() -> int {
+    auto bpq = StaticBPQueue<int, -3, 3>{};
+    auto a = Item{std::make_pair(1, uint32_t(0))};
+    auto b = Item{std::make_pair(2, uint32_t(0))};
+    bpq.append(a, 2);
+    bpq.appendleft(b, -1);
+    bpq.modify_key(b, 4);
+    auto count = 0;
+    for (auto &it : bpq) {
+        count += it.data.first;
+    }
+    return count * 100 + bpq.popleft().data.first * 10 + bpq.get_max();
+}
+
+static_assert(compile_time_play() == 322, "usable at compile time");
+
+TEST_CASE("Test StaticBPQueue") {
+    auto bpq = StaticBPQueue<int, -3, 3>{};
+    CHECK(bpq.is_empty());
+    CHECK_EQ(bpq.get_max(), -4);
+    auto a = Item{std::make_pair(3, uint32_t(0))};
+    bpq.appendleft_direct(a);
+    CHECK_EQ(bpq.get_max(), 0);
+    bpq.increase_key(a, 1);
+    CHECK_EQ(bpq.get_max(), 1);
+    bpq.decrease_key(a, 2);
+    CHECK_EQ(bpq.get_max(), -1);
+    bpq.detach(a);
+    CHECK(bpq.is_empty());
+    CHECK_EQ(bpq.get_max(), -4);
+    bpq.set_key(a, 0);
+    CHECK_EQ(a.data.second, 4);
+}
+
+TEST_CASE("Test StaticBPQueue vs BPQueue") {
+    auto bpq1 = BPQueue<int, int32_t>{-3, 3};
+    auto bpq2 = StaticBPQueue<int, -3, 3>{};
+    auto nodes1 = std::vector<Item>(3);
+    auto nodes2 = std::vector<Item>(3);
+    for (auto i = 0U; i != 3U; ++i) {
+        nodes1[i].data.first = nodes2[i].data.first = int(i);
+    }
+    CHECK_EQ(play(bpq1, nodes1), play(bpq2, nodes2));
+
+    auto items = std::vector<Item *>{&nodes2[0], &nodes2[2]};
+    bpq2.modify_keys(items, std::vector<int>{-2, 2});
+    CHECK_EQ(bpq2.get_max(), 3);
+    bpq2.clear();
+    CHECK(bpq2.is_empty());
+
+    const auto gains = std::vector<int>{1, -3, 1};
+    bpq1.clear();
+    bpq1.build(nodes1, gains);
+    bpq2.build(nodes2, gains);
+    auto top1 = std::vector<Item *>{};
+    auto top2 = std::vector<Item *>{};
+    bpq1.top_k(2, std::back_inserter(top1));
+    bpq2.top_k(2, std::back_inserter(top2));
+    CHECK_EQ(top2.size(), 2U);
+    CHECK_EQ(top1[0]->data.first, top2[0]->data.first);
+    CHECK_EQ(top1[1]->data.first, top2[1]->data.first);
+    CHECK_EQ(bpq1.get_max(), bpq2.get_max());
+}
+
+TEST_CASE("Test StaticBPQueue with 8-bit keys") {
+    using Item8 = Dllink<std::pair<int, uint8_t>>;
+    auto bpq = StaticBPQueue<int, -120, 120, int8_t>{};
+    auto a = Item8{std::make_pair(1, uint8_t(0))};
+    auto b = Item8{std::make_pair(2, uint8_t(0))};
+    bpq.append(a, int8_t(120));
+    bpq.append(b, int8_t(-120));
+    CHECK_EQ(bpq.get_max(), 120);
+    bpq.modify_key(a, int8_t(-100));
+    CHECK_EQ(bpq.get_max(), 20);
+    CHECK_EQ(bpq.popleft().data.first, 1);
+    CHECK_EQ(bpq.get_max(), -120);
+}
@@ -1,7 +1,6 @@
 add_rules("mode.debug", "mode.release", "mode.coverage")
 add_requires("doctest", {alias = "doctest"})
 add_requires("fmt", {alias = "fmt"})
--- add_requires("benchmark", {alias = "benchmark"})
 
 if is_mode("coverage") then
     add_cxflags("-ftest-coverage", "-fprofile-arcs", {force = true})
@@ -14,16 +13,83 @@ elseif is_plat("windows") then
     add_cxflags("/EHsc /W4 /WX /wd4819 /wd4996", {force = true})
 end
 
+option("bench")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Build the benchmarks (requires Google Benchmark)")
+option_end()
+
+option("py2cpp_includedir")
+    set_default("../py2cpp/include")
+    set_showmenu(true)
+    set_description("Include directory of py2cpp (needed by lict.hpp)")
+option_end()
+
+option("pch")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Precompile the mywheel headers")
+option_end()
+
+option("extern_templates")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Instantiate the common BPQueue specializations only once")
+option_end()
+
+option("modules")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Build the mywheel C++20 module")
+option_end()
+
+if has_config("modules") then
+    target("mywheel_module")
+        set_languages("c++20")
+        set_kind("static")
+        add_includedirs("include", {public = true})
+        add_includedirs(get_config("py2cpp_includedir"), {public = true})
+        add_files("source/mywheel.cppm", {public = true})
+end
+
+if has_config("extern_templates") then
+    target("mywheel_instances")
+        set_languages("c++17")
+        set_kind("static")
+        add_includedirs("include", {public = true})
+        add_defines("MYWHEEL_EXTERN_TEMPLATES", {public = true})
+        add_files("source/mywheel_instances.cpp")
+end
 
 target("test_mywheel")
     set_languages("c++17")
     set_kind("binary")
     add_includedirs("include", {public = true})
-    add_includedirs("../py2cpp/include", {public = true})
+    add_includedirs(get_config("py2cpp_includedir"), {public = true})
     add_files("test/source/*.cpp")
     add_packages("doctest", "fmt")
+    if has_config("pch") then
+        set_pcxxheader("include/mywheel/pch.hpp")
+    end
+    if has_config("extern_templates") then
+        add_deps("mywheel_instances")
+    end
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
     -- require py2cpp installed
 
+if has_config("bench") then
+    add_requires("benchmark", {alias = "benchmark"})
+
+    target("bench_mywheel")
+        set_languages("c++17")
+        set_kind("binary")
+        add_includedirs("include", {public = true})
+        add_files("bench/source/*.cpp")
+        add_packages("benchmark")
+end
+
 
 -- If you want to known more usage about xmake, please see https://xmake.io
 --